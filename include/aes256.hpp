@@ -0,0 +1,160 @@
+/**
+ * @file aes256.hpp
+ * @brief AES-256 block cipher (FIPS 197) for the standard CTR_DRBG
+ *
+ * The reference cipher is constexpr and constant-time: SubBytes goes through
+ * the S-box circuit rather than a table, and the GF(2^8) doubling in
+ * MixColumns uses a mask instead of a branch. Counter-mode keystream is
+ * dispatched at startup to an AES-NI kernel when the CPU supports it.
+ */
+
+#ifndef AES256_HPP
+#define AES256_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+#include "sbox_circuit.hpp"
+
+namespace aes256_detail {
+    // Multiplication by x in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1
+    constexpr uint8_t xtime(uint8_t x) {
+        return static_cast<uint8_t>((x << 1) ^ (0x1b & (0u - (x >> 7))));
+    }
+
+    /**
+     * @brief Apply the S-box to n <= 32 bytes in place, without table lookups
+     */
+    constexpr void sub_bytes(uint8_t* s, size_t n) {
+        // Bit i of plane b: bit b of byte i
+        uint32_t q[8] = {};
+        for (size_t i = 0; i < n; ++i) {
+            for (int b = 0; b < 8; ++b) {
+                q[b] |= static_cast<uint32_t>((s[i] >> b) & 1) << i;
+            }
+        }
+        aes_sbox_circuit(q);
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t value = 0;
+            for (int b = 0; b < 8; ++b) {
+                value |= static_cast<uint8_t>(((q[b] >> i) & 1) << b);
+            }
+            s[i] = value;
+        }
+    }
+}
+
+/**
+ * @class AES256
+ * @brief AES-256 encryption: key schedule, single blocks and CTR keystream
+ */
+class AES256 {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;  // 128-bit blocks
+    static constexpr size_t KEY_SIZE = 32;    // 256-bit key
+    static constexpr int ROUNDS = 14;
+
+    using Block = std::array<uint8_t, BLOCK_SIZE>;
+    using Key = std::array<uint8_t, KEY_SIZE>;
+    // Round keys 0..ROUNDS, 16 bytes each, in FIPS 197 byte order
+    using RoundKeys = std::array<uint8_t, BLOCK_SIZE * (ROUNDS + 1)>;
+
+    /**
+     * @brief FIPS 197 key expansion
+     */
+    static constexpr RoundKeys expandKey(const Key& key) {
+        RoundKeys rk = {};
+        for (size_t i = 0; i < KEY_SIZE; ++i) {
+            rk[i] = key[i];
+        }
+
+        uint8_t rcon = 0x01;
+        for (size_t i = KEY_SIZE; i < rk.size(); i += 4) {
+            uint8_t temp[4] = {rk[i - 4], rk[i - 3], rk[i - 2], rk[i - 1]};
+            if (i % KEY_SIZE == 0) {
+                // RotWord, SubWord, Rcon
+                uint8_t first = temp[0];
+                temp[0] = temp[1];
+                temp[1] = temp[2];
+                temp[2] = temp[3];
+                temp[3] = first;
+                aes256_detail::sub_bytes(temp, 4);
+                temp[0] ^= rcon;
+                rcon = aes256_detail::xtime(rcon);
+            } else if (i % KEY_SIZE == 16) {
+                aes256_detail::sub_bytes(temp, 4);
+            }
+            for (size_t j = 0; j < 4; ++j) {
+                rk[i + j] = rk[i + j - KEY_SIZE] ^ temp[j];
+            }
+        }
+        return rk;
+    }
+
+    /**
+     * @brief Encrypt one block with the constant-time reference rounds
+     * @param rk Expanded key from expandKey()
+     * @param block 128-bit plaintext block
+     * @return 128-bit ciphertext block
+     *
+     * Usable in constant expressions; also the body of the software keystream
+     * kernel, so the compile-time known-answer tests cover the fallback.
+     */
+    static constexpr Block encryptBlock(const RoundKeys& rk, const Block& block) {
+        Block s = {};
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            s[i] = block[i] ^ rk[i];
+        }
+
+        for (int round = 1; round <= ROUNDS; ++round) {
+            aes256_detail::sub_bytes(s.data(), BLOCK_SIZE);
+
+            // ShiftRows: byte r of column c comes from column c + r
+            Block t = {};
+            for (size_t c = 0; c < 4; ++c) {
+                for (size_t r = 0; r < 4; ++r) {
+                    t[4 * c + r] = s[4 * ((c + r) % 4) + r];
+                }
+            }
+
+            // MixColumns, skipped in the last round
+            if (round < ROUNDS) {
+                for (size_t c = 0; c < 16; c += 4) {
+                    uint8_t all = t[c] ^ t[c + 1] ^ t[c + 2] ^ t[c + 3];
+                    uint8_t first = t[c];
+                    t[c] ^= all ^ aes256_detail::xtime(t[c] ^ t[c + 1]);
+                    t[c + 1] ^= all ^ aes256_detail::xtime(t[c + 1] ^ t[c + 2]);
+                    t[c + 2] ^= all ^ aes256_detail::xtime(t[c + 2] ^ t[c + 3]);
+                    t[c + 3] ^= all ^ aes256_detail::xtime(t[c + 3] ^ first);
+                }
+            }
+
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                s[i] = t[i] ^ rk[round * BLOCK_SIZE + i];
+            }
+        }
+        return s;
+    }
+
+    /**
+     * @brief CTR-mode keystream: increment the counter, then encrypt it
+     * @param rk Expanded key
+     * @param counter 128-bit big-endian counter, advanced by num_blocks
+     * @param out Destination for num_blocks * BLOCK_SIZE bytes
+     * @param num_blocks Number of blocks to produce
+     *
+     * The increment-before-encrypt order is the one SP 800-90A uses for V.
+     * Runs on AES-NI with eight blocks in flight when available.
+     */
+    static void ctrKeystream(const RoundKeys& rk, uint8_t counter[BLOCK_SIZE],
+                             uint8_t* out, size_t num_blocks);
+
+    /**
+     * @brief Name of the keystream kernel selected at startup
+     * @return "AES-NI" or "software"
+     */
+    static std::string kernelName();
+};
+
+#endif // AES256_HPP
@@ -0,0 +1,189 @@
+/**
+ * @file async_drbg.hpp
+ * @brief Awaitable DRBG requests for coroutine-based event loops
+ *
+ * A 10^7-bit request takes milliseconds, which is too long to block an
+ * event-loop thread. AsyncDRBG::asyncGenerate() returns an awaitable: small
+ * requests complete inline, large ones run chunk by chunk on a WorkerPool
+ * and the awaiting coroutine is resumed through an Executor of the caller's
+ * choosing, typically its own EventLoop.
+ */
+
+#ifndef ASYNC_DRBG_HPP
+#define ASYNC_DRBG_HPP
+
+#include "drbg.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Executor
+ * @brief Somewhere to run a task later; post() may be called from any thread
+ */
+class Executor {
+public:
+    virtual ~Executor() = default;
+    virtual void post(std::function<void()> task) = 0;
+};
+
+/**
+ * @class WorkerPool
+ * @brief Fixed set of threads running posted tasks in FIFO order
+ *
+ * The destructor finishes every task already posted before joining.
+ */
+class WorkerPool : public Executor {
+public:
+    /**
+     * @param threads Worker count; 0 selects std::thread::hardware_concurrency()
+     */
+    explicit WorkerPool(size_t threads = 0);
+    ~WorkerPool() override;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void post(std::function<void()> task) override;
+
+    size_t threadCount() const { return workers.size(); }
+
+private:
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> queue;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void work();
+};
+
+/**
+ * @class EventLoop
+ * @brief Single-threaded run queue, driven by whichever thread calls run*()
+ */
+class EventLoop : public Executor {
+public:
+    void post(std::function<void()> task) override;
+
+    /**
+     * @brief Run every task posted so far, without waiting
+     * @return Number of tasks run
+     */
+    size_t poll();
+
+    /**
+     * @brief Run tasks as they arrive until the deadline passes
+     * @return Number of tasks run
+     *
+     * A task that is still running at the deadline makes this return late;
+     * that lateness is what an event loop's timers would see.
+     */
+    size_t runUntil(std::chrono::steady_clock::time_point deadline);
+
+private:
+    std::mutex lock;
+    std::condition_variable ready;
+    std::vector<std::function<void()>> queue;
+};
+
+/**
+ * @struct AsyncTask
+ * @brief Return type for fire-and-forget coroutines
+ *
+ * The coroutine starts immediately and frees its frame when it finishes.
+ * An exception escaping it terminates the program, as from a std::thread.
+ */
+struct AsyncTask {
+    struct promise_type {
+        AsyncTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * @class AsyncDRBG
+ * @brief Thread-safe DRBG facade with a coroutine generate API
+ *
+ * Every call into the wrapped DRBG holds one mutex. A large asynchronous
+ * request is issued as a series of CHUNK_BYTES requests, each posted to the
+ * pool as its own task, so the mutex is never held for more than one chunk
+ * and inline requests from the event loop wait at most that long. Its
+ * output is therefore that of consecutive CHUNK_BYTES requests, not of one
+ * generateInto() call of the full size.
+ */
+class AsyncDRBG : public DRBG {
+public:
+    // Requests up to this size complete inside co_await, with no handoff
+    static constexpr size_t INLINE_BYTES = 4096;
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    /**
+     * @brief Awaitable returned by asyncGenerate()
+     *
+     * Must be awaited at most once. Rethrows from co_await anything the
+     * DRBG threw.
+     */
+    class GenerateOperation {
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume();
+
+    private:
+        friend class AsyncDRBG;
+        GenerateOperation(AsyncDRBG& owner, uint8_t* out, size_t num_bits, Executor* resume_on)
+            : owner(owner), out(out), remaining_bits(num_bits), resume_on(resume_on) {}
+
+        AsyncDRBG& owner;
+        uint8_t* out;
+        size_t remaining_bits;
+        Executor* resume_on;
+        std::coroutine_handle<> caller;
+        std::exception_ptr error;
+
+        void run_chunk();
+    };
+
+    /**
+     * @param drbg Wrapped generator; must outlive this object and must not
+     *             be used directly while it exists
+     * @param pool Runs large requests; must outlive every pending request
+     */
+    AsyncDRBG(DRBG& drbg, WorkerPool& pool) : drbg(drbg), pool(pool) {}
+
+    /**
+     * @brief Generate num_bits into out without blocking the caller's thread
+     * @param out Destination; must stay valid until the co_await completes
+     * @param num_bits Number of bits to generate
+     * @param resume_on Executor that resumes the awaiting coroutine, or
+     *                  nullptr to resume it on the worker thread
+     */
+    GenerateOperation asyncGenerate(uint8_t* out, size_t num_bits, Executor* resume_on = nullptr) {
+        return GenerateOperation(*this, out, num_bits, resume_on);
+    }
+
+    // Blocking request, serialized with the asynchronous chunks
+    void generateInto(uint8_t* out, size_t num_bits) override;
+    void reseed(const std::vector<uint8_t>& seed) override;
+    std::string getName() const override { return drbg.getName() + "/async"; }
+    size_t getStateSize() const override { return drbg.getStateSize(); }
+
+private:
+    DRBG& drbg;
+    WorkerPool& pool;
+    std::mutex lock;
+};
+
+#endif // ASYNC_DRBG_HPP
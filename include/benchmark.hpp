@@ -7,11 +7,17 @@
 #define BENCHMARK_HPP
 
 #include "drbg.hpp"
+#include "drbg_reader.hpp"
+#include "drbg_pool.hpp"
+#include "async_drbg.hpp"
+#include "locked_drbg.hpp"
 #include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 /**
  * @struct BenchmarkResult
@@ -22,7 +28,8 @@ struct BenchmarkResult {
     size_t num_bits;
     
     // Timing metrics (in microseconds)
-    double generation_time_us;
+    double generation_time_us;       // generate(): allocates the result vector
+    double generation_into_time_us;  // generateInto(): preallocated buffer
     
     // Space metrics (in bytes)
     size_t state_size;
@@ -36,6 +43,154 @@ struct BenchmarkResult {
     
     // Derived metrics
     double bits_per_microsecond;
+    double bits_per_microsecond_into;
+};
+
+/**
+ * @class Timer
+ * @brief High-resolution timer for benchmarking
+ */
+class Timer {
+private:
+    std::chrono::high_resolution_clock::time_point start_time;
+    
+public:
+    void start() {
+        start_time = std::chrono::high_resolution_clock::now();
+    }
+    
+    double elapsedMicroseconds() const {
+        auto end_time = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(end_time - start_time).count();
+    }
+    
+    double elapsedMilliseconds() const {
+        return elapsedMicroseconds() / 1000.0;
+    }
+};
+
+/**
+ * @struct SmallRequestResult
+ * @brief Per-call cost of one fixed-size request through both generate APIs
+ */
+struct SmallRequestResult {
+    std::string drbg_name;
+    size_t num_bits;
+    double vector_ns;  // generate(num_bits): heap-allocated vector
+    double array_ns;   // generate<num_bits>(): std::array on the stack
+};
+
+/**
+ * @struct DrawResult
+ * @brief Throughput of 64-bit integer draws from one DRBG
+ */
+struct DrawResult {
+    std::string drbg_name;
+    size_t buffer_bytes;       // DRBGReader buffer; 0 = one generate(64) per draw
+    double draws_per_second;
+};
+
+/**
+ * @struct UniformResult
+ * @brief Throughput of bounded integers in [0, n) through each sampler
+ */
+struct UniformResult {
+    std::string drbg_name;
+    uint32_t bound;
+    double std_mvalues_per_second;    // std::uniform_int_distribution
+    double below_mvalues_per_second;  // Uniform::below, one value per call
+    double fill_mvalues_per_second;   // Uniform::fillBelow, whole array
+};
+
+/**
+ * @struct RealResult
+ * @brief Throughput of uniform and normal reals from one DRBG
+ */
+struct RealResult {
+    std::string drbg_name;
+    double std_uniform_mvalues_per_second;  // std::uniform_real_distribution<double>
+    double doubles_mvalues_per_second;      // Uniform::fillDoubles
+    double floats_mvalues_per_second;       // Uniform::fillFloats
+    double std_normal_mvalues_per_second;   // std::normal_distribution<double>
+    double normal_mvalues_per_second;       // Normal::fill
+};
+
+/**
+ * @struct ShuffleResult
+ * @brief Shuffle and reservoir-sampling throughput at one array size
+ */
+struct ShuffleResult {
+    std::string drbg_name;
+    size_t num_elements;
+    double std_shuffle_melements_per_second;  // std::shuffle over a DRBGReader
+    double shuffle_melements_per_second;      // Sampling::shuffle
+    double reservoir_melements_per_second;    // Sampling::reservoirSample, k = 1000
+};
+
+/**
+ * @struct PoolScalingResult
+ * @brief Aggregate request rate from many threads sharing one DRBG
+ */
+struct PoolScalingResult {
+    std::string drbg_name;
+    size_t num_threads;
+    double locked_mrequests_per_second;      // One instance behind a std::mutex
+    double per_thread_mrequests_per_second;  // DRBGPool, Sharding::PerThread
+    double per_core_mrequests_per_second;    // DRBGPool, Sharding::PerCore
+};
+
+/**
+ * @struct SharedCounterResult
+ * @brief Aggregate request rate of one shared CTR generator across threads
+ */
+struct SharedCounterResult {
+    size_t num_threads;
+    double locked_ctr_mrequests_per_second;  // CTR_DRBG (T-table) behind a std::mutex
+    double locked_aes_mrequests_per_second;  // AES_CTR_DRBG behind a std::mutex
+    double shared_mrequests_per_second;      // SharedCTR_DRBG, no lock
+};
+
+/**
+ * @struct ContentionResult
+ * @brief Throughput and per-request latency of one thread-safety strategy
+ */
+struct ContentionResult {
+    std::string drbg_name;
+    std::string strategy;       // "mutex", "spinlock" or "sharded"
+    size_t num_threads;
+    size_t num_bits;            // Per request
+    double mbytes_per_second;   // All threads combined
+    double p50_us;
+    double p99_us;
+};
+
+/**
+ * @struct PrefetchLatencyResult
+ * @brief Per-request latency percentiles, direct vs served by DRBGPrefetcher
+ */
+struct PrefetchLatencyResult {
+    std::string drbg_name;
+    size_t num_bits;
+    double direct_p50_ns;
+    double direct_p99_ns;
+    double prefetch_p50_ns;
+    double prefetch_p99_ns;
+    double miss_percent;  // Prefetched requests that found the ring empty
+};
+
+/**
+ * @struct LoopResponsivenessResult
+ * @brief Event-loop timer lateness while bulk requests are in flight
+ */
+struct LoopResponsivenessResult {
+    std::string drbg_name;
+    size_t num_bits;            // Per bulk request
+    double blocking_ms;         // All requests, generateInto() on the loop thread
+    double blocking_p99_us;     // Tick lateness
+    double blocking_max_us;
+    double async_ms;            // All requests, co_await AsyncDRBG::asyncGenerate()
+    double async_p99_us;
+    double async_max_us;
 };
 
 /**
@@ -49,9 +204,190 @@ public:
      * @param drbg Pointer to the DRBG to benchmark
      * @param num_bits Number of bits to generate
      * @return BenchmarkResult containing all metrics
+     *
+     * Times one generate() call and then one generateInto() call of the same
+     * size; the bit distribution is taken from the generate() output.
      */
     static BenchmarkResult run(DRBG* drbg, size_t num_bits);
     
+    /**
+     * @brief Time a run of fixed-size requests through both generate APIs
+     * @tparam Bits Request size in bits
+     * @param drbg Concrete DRBG (generate<Bits>() is not virtual)
+     * @param iterations Number of requests per API
+     * @return Average nanoseconds per request for each API
+     */
+    template <size_t Bits, typename ConcreteDRBG>
+    static SmallRequestResult runSmallRequests(ConcreteDRBG& drbg, size_t iterations) {
+        SmallRequestResult result;
+        result.drbg_name = drbg.getName();
+        result.num_bits = Bits;
+        
+        // Every output feeds the sink so no request can be optimized away
+        volatile uint8_t sink = 0;
+        Timer timer;
+        
+        timer.start();
+        for (size_t i = 0; i < iterations; ++i) {
+            sink = static_cast<uint8_t>(sink ^ drbg.generate(Bits)[0]);
+        }
+        result.vector_ns = timer.elapsedMicroseconds() * 1000.0 / iterations;
+        
+        timer.start();
+        for (size_t i = 0; i < iterations; ++i) {
+            sink = static_cast<uint8_t>(sink ^ drbg.template generate<Bits>()[0]);
+        }
+        result.array_ns = timer.elapsedMicroseconds() * 1000.0 / iterations;
+        
+        return result;
+    }
+    
+    /**
+     * @brief Time a run of 64-bit draws, buffered or one request per draw
+     * @param drbg DRBG to draw from
+     * @param buffer_bytes DRBGReader buffer size, or 0 to call generateInto() per draw
+     * @param num_draws Number of draws to time
+     */
+    static DrawResult runDraws(DRBG& drbg, size_t buffer_bytes, size_t num_draws);
+    
+    /**
+     * @brief Time bounded-integer sampling from one DRBG three ways
+     * @param drbg DRBG feeding every sampler (through its own DRBGReader)
+     * @param bound Exclusive upper bound n
+     * @param count Number of values per sampler
+     */
+    static UniformResult runUniform(DRBG& drbg, uint32_t bound, size_t count);
+    
+    /**
+     * @brief Time uniform and normal real generation from one DRBG
+     * @param drbg DRBG feeding every sampler (through its own DRBGReader)
+     * @param count Number of values per sampler
+     */
+    static RealResult runReals(DRBG& drbg, size_t count);
+    
+    /**
+     * @brief Time shuffling and sampling a uint32_t array of the given size
+     * @param drbg DRBG feeding every routine
+     * @param num_elements Array length
+     */
+    static ShuffleResult runShuffle(DRBG& drbg, size_t num_elements);
+    
+    /**
+     * @brief Time 256-bit requests from num_threads threads to one shared generator
+     * @param seed Seed for every generator
+     * @param num_threads Number of concurrent threads
+     * @param total_requests Requests split evenly across the threads
+     */
+    static SharedCounterResult runSharedCounter(const std::vector<uint8_t>& seed,
+                                                size_t num_threads, size_t total_requests);
+    
+    /**
+     * @brief Time one request size from num_threads threads under each locking strategy
+     * @tparam D Concrete DRBG class
+     * @param seed Seed for the shared instance and the sharded master
+     * @param num_threads Number of concurrent threads
+     * @param num_bits Request size
+     * @param total_requests Requests split evenly across the threads
+     * @return One result each for MutexDRBG, SpinLockDRBG and ShardedDRBG<D>
+     */
+    template <typename D>
+    static std::vector<ContentionResult> runContention(const std::vector<uint8_t>& seed,
+                                                       size_t num_threads, size_t num_bits,
+                                                       size_t total_requests) {
+        size_t per_thread = std::max<size_t>(1, total_requests / num_threads);
+        std::vector<ContentionResult> results;
+        
+        D shared(seed);
+        MutexDRBG mutex_drbg(shared);
+        results.push_back(timeContention(mutex_drbg, "mutex", num_threads, num_bits, per_thread));
+        SpinLockDRBG spin_drbg(shared);
+        results.push_back(timeContention(spin_drbg, "spinlock", num_threads, num_bits, per_thread));
+        ShardedDRBG<D> sharded(seed);
+        results.push_back(timeContention(sharded, "sharded", num_threads, num_bits, per_thread));
+        
+        for (auto& r : results) {
+            r.drbg_name = shared.getName();
+        }
+        return results;
+    }
+    
+    /**
+     * @brief Time individual requests, direct and through a DRBGPrefetcher
+     * @param drbg DRBG to request from (wrapped by the prefetcher in turn)
+     * @param num_bits Request size
+     * @param num_requests Requests per mode
+     *
+     * Requests come in short bursts separated by idle gaps, as from a server
+     * handing out keys, which gives the producer time to refill.
+     */
+    static PrefetchLatencyResult runPrefetchLatency(DRBG& drbg, size_t num_bits, size_t num_requests);
+    
+    /**
+     * @brief Measure how late an event loop's periodic tick runs during bulk requests
+     * @param drbg DRBG to request from
+     * @param pool Workers for the asynchronous run
+     * @param num_bits Size of each bulk request
+     * @param num_requests Bulk requests issued back to back from the loop
+     *
+     * The loop re-arms a 500 us tick after every firing and records how far
+     * past its deadline each one ran, first with blocking requests issued as
+     * loop tasks and then with the same requests awaited from a coroutine.
+     */
+    static LoopResponsivenessResult runLoopResponsiveness(DRBG& drbg, WorkerPool& pool,
+                                                          size_t num_bits, size_t num_requests);
+    
+    /**
+     * @brief Time 256-bit requests from num_threads threads, locked vs pooled
+     * @tparam D Concrete DRBG class
+     * @param seed Seed for the shared instance and the pools' masters
+     * @param factory Builds a D from seed material
+     * @param num_threads Number of concurrent threads
+     * @param total_requests Requests split evenly across the threads
+     */
+    template <typename D>
+    static PoolScalingResult runPoolScaling(const std::vector<uint8_t>& seed,
+                                            typename DRBGPool<D>::Factory factory,
+                                            size_t num_threads, size_t total_requests) {
+        constexpr size_t REQUEST_BITS = 256;
+        size_t per_thread = total_requests / num_threads;
+        
+        PoolScalingResult result;
+        result.num_threads = num_threads;
+        auto rate = [&](double elapsed_us) {
+            return (elapsed_us > 0) ? per_thread * num_threads / elapsed_us : 0;
+        };
+        
+        {
+            D shared = factory(seed);
+            result.drbg_name = shared.getName();
+            std::mutex lock;
+            result.locked_mrequests_per_second = rate(timeThreads(num_threads, [&] {
+                uint8_t out[REQUEST_BITS / 8];
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    shared.generateInto(out, REQUEST_BITS);
+                }
+            }));
+        }
+        
+        for (auto mode : {DRBGPool<D>::Sharding::PerThread, DRBGPool<D>::Sharding::PerCore}) {
+            DRBGPool<D> pool(seed, mode, factory);
+            double mrequests = rate(timeThreads(num_threads, [&] {
+                uint8_t out[REQUEST_BITS / 8];
+                for (size_t i = 0; i < per_thread; ++i) {
+                    pool.generateInto(out, REQUEST_BITS);
+                }
+            }));
+            if (mode == DRBGPool<D>::Sharding::PerThread) {
+                result.per_thread_mrequests_per_second = mrequests;
+            } else {
+                result.per_core_mrequests_per_second = mrequests;
+            }
+        }
+        
+        return result;
+    }
+    
     /**
      * @brief Count zeros and ones in a byte array
      * @param data The byte array to analyze
@@ -81,28 +417,26 @@ public:
      */
     static void generateHTMLVisualization(const std::vector<BenchmarkResult>& results, 
                                           const std::string& filename);
-};
 
-/**
- * @class Timer
- * @brief High-resolution timer for benchmarking
- */
-class Timer {
 private:
-    std::chrono::high_resolution_clock::time_point start_time;
-    
-public:
-    void start() {
-        start_time = std::chrono::high_resolution_clock::now();
-    }
+    // Throughput and p50/p99 latency of per_thread num_bits-bit requests
+    // issued to drbg from each of num_threads threads at once
+    static ContentionResult timeContention(DRBG& drbg, const std::string& strategy,
+                                           size_t num_threads, size_t num_bits, size_t per_thread);
     
-    double elapsedMicroseconds() const {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double, std::micro>(end_time - start_time).count();
-    }
-    
-    double elapsedMilliseconds() const {
-        return elapsedMicroseconds() / 1000.0;
+    // Wall time in microseconds for num_threads threads each running body
+    template <typename Fn>
+    static double timeThreads(size_t num_threads, Fn body) {
+        std::vector<std::thread> workers;
+        Timer timer;
+        timer.start();
+        for (size_t t = 0; t < num_threads; ++t) {
+            workers.emplace_back(body);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return timer.elapsedMicroseconds();
     }
 };
 
@@ -0,0 +1,33 @@
+/**
+ * @file cpu_features.hpp
+ * @brief Runtime CPU feature detection used to select accelerated kernels
+ */
+
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+#include <cstddef>
+
+/**
+ * @struct CpuFeatures
+ * @brief Instruction set extensions available on the running CPU
+ *
+ * Populated once via cpuid (and xgetbv for AVX state support). On non-x86
+ * targets every flag is false and callers fall back to portable code.
+ */
+struct CpuFeatures {
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool aesni = false;
+    bool sha = false;      // SHA-256 extensions (sha256rnds2/msg1/msg2)
+    bool avx2 = false;     // AVX2 with OS-enabled YMM state
+    bool avx512f = false;  // AVX-512F with OS-enabled ZMM state
+    size_t llc_bytes = 0;  // Largest data/unified cache; 0 if not reported
+
+    /**
+     * @brief Get the features of the running CPU (detected on first use)
+     */
+    static const CpuFeatures& get();
+};
+
+#endif // CPU_FEATURES_HPP
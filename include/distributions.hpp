@@ -0,0 +1,103 @@
+/**
+ * @file distributions.hpp
+ * @brief Unbiased integers, unit-interval reals and normals from a DRBGReader
+ *
+ * Reducing a random word modulo n favours small residues whenever n does not
+ * divide 2^32. Uniform instead takes the high half of the product x * n
+ * (Lemire, "Fast Random Integer Generation in an Interval", 2019) and
+ * rejects the few x whose low half falls below 2^32 mod n. The division that
+ * computes that threshold only runs when the low half is below n, so most
+ * draws cost one multiplication. Bounds above 2^26 draw 64-bit words, which
+ * keeps the rejection rate negligible right up to 2^32.
+ */
+
+#ifndef DISTRIBUTIONS_HPP
+#define DISTRIBUTIONS_HPP
+
+#include "drbg_reader.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @class Uniform
+ * @brief Uniform integers in [0, n) and [lo, hi] without modulo bias
+ */
+class Uniform {
+public:
+    /**
+     * @brief Uniform integer in [0, n)
+     * @throws std::invalid_argument if n is 0
+     */
+    static uint32_t below(DRBGReader& rng, uint32_t n);
+    static uint64_t below64(DRBGReader& rng, uint64_t n);
+
+    /**
+     * @brief Uniform integer in [lo, hi], both ends included
+     * @throws std::invalid_argument if lo > hi
+     */
+    static int64_t range(DRBGReader& rng, int64_t lo, int64_t hi);
+
+    /**
+     * @brief Fill out[0..count) with uniform integers in [0, n)
+     * @throws std::invalid_argument if n is 0
+     *
+     * All count words are read in one request (large ones bypass the reader's
+     * buffer and go straight to the DRBG), then mapped in place; only the
+     * rejected words are redrawn, one at a time. The mapping runs eight
+     * lanes wide on AVX2. Bounds above 2^26 take 64-bit words in chunks
+     * through the reader instead.
+     */
+    static void fillBelow(DRBGReader& rng, uint32_t n, uint32_t* out, size_t count);
+
+    /**
+     * @brief Uniform double in [0, 1) with 52 random mantissa bits
+     */
+    static double unitDouble(DRBGReader& rng);
+
+    /**
+     * @brief Fill out[0..count) with uniform values in [0, 1)
+     *
+     * The raw words are read into out in one request and converted in place:
+     * the top mantissa bits are placed under the exponent of 1.0, which
+     * gives [1, 2), and 1 is subtracted. Doubles carry 52 random bits and
+     * floats 23.
+     */
+    static void fillDoubles(DRBGReader& rng, double* out, size_t count);
+    static void fillFloats(DRBGReader& rng, float* out, size_t count);
+
+    /**
+     * @brief Name of the bulk kernels selected at startup
+     * @return "AVX2" or "scalar"
+     */
+    static std::string kernelName();
+};
+
+/**
+ * @class Normal
+ * @brief Gaussian variates from a 128-layer ziggurat
+ *
+ * About 99% of draws take one 64-bit word, a table lookup and a compare; the
+ * rest fall in a wedge or the tail and draw more words.
+ */
+class Normal {
+public:
+    /**
+     * @brief One standard normal variate
+     */
+    static double sample(DRBGReader& rng);
+
+    /**
+     * @brief Fill out[0..count) with normal variates
+     * @throws std::invalid_argument if stddev is not positive
+     *
+     * Words are read in bulk like Uniform::fillDoubles(). The fast path runs
+     * four lanes wide on AVX2; blocks with a wedge or tail draw are finished
+     * by the scalar sampler in index order, so every kernel gives the same
+     * output.
+     */
+    static void fill(DRBGReader& rng, double* out, size_t count,
+                     double mean = 0.0, double stddev = 1.0);
+};
+
+#endif // DISTRIBUTIONS_HPP
@@ -3,7 +3,8 @@
  * @brief Abstract base class and implementations for Deterministic Random Bit Generators (DRBG)
  * 
  * This file contains implementations of three CS-PRNG algorithms:
- * 1. CTR-DRBG (Counter mode DRBG) - Based on AES-like block cipher
+ * 1. CTR-DRBG (Counter mode DRBG) - Based on AES-like block cipher, and the
+ *    standard AES-256 variant
  * 2. Hash-DRBG - Based on SHA-256 hash function
  * 3. HMAC-DRBG - Based on HMAC-SHA256
  */
@@ -16,6 +17,10 @@
 #include <string>
 #include <array>
 #include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "sha256.hpp"
+#include "aes256.hpp"
 
 /**
  * @class DRBG
@@ -29,8 +34,22 @@ public:
      * @brief Generate random bits
      * @param num_bits Number of bits to generate
      * @return Vector of bytes containing the random bits
+     *
+     * Convenience wrapper that allocates the result and fills it through
+     * generateInto().
      */
-    virtual std::vector<uint8_t> generate(size_t num_bits) = 0;
+    std::vector<uint8_t> generate(size_t num_bits) {
+        std::vector<uint8_t> result((num_bits + 7) / 8);
+        generateInto(result.data(), num_bits);
+        return result;
+    }
+    
+    /**
+     * @brief Generate random bits straight into caller-provided memory
+     * @param out Destination for (num_bits + 7) / 8 bytes
+     * @param num_bits Number of bits to generate
+     */
+    virtual void generateInto(uint8_t* out, size_t num_bits) = 0;
     
     /**
      * @brief Reseed the DRBG with new entropy
@@ -51,6 +70,34 @@ public:
     virtual size_t getStateSize() const = 0;
 };
 
+namespace ctr_drbg_detail {
+    // Little-endian word <-> byte helpers for the word-oriented SPN rounds
+    constexpr uint32_t load_le32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    constexpr void store_le32(uint8_t* p, uint32_t w) {
+        p[0] = static_cast<uint8_t>(w);
+        p[1] = static_cast<uint8_t>(w >> 8);
+        p[2] = static_cast<uint8_t>(w >> 16);
+        p[3] = static_cast<uint8_t>(w >> 24);
+    }
+
+    constexpr uint8_t byte_of(const uint32_t* words, size_t i) {
+        return static_cast<uint8_t>(words[i / 4] >> (8 * (i % 4)));
+    }
+
+    // MixColumns on one little-endian column word:
+    // x_j ^= t ^ ((x_j ^ x_{j+1}) << 1), with t the XOR of the column
+    constexpr uint32_t mix_column(uint32_t x) {
+        uint32_t fold = x ^ (x >> 16);
+        fold = (fold ^ (fold >> 8)) & 0xFF;
+        uint32_t next = (x >> 8) | (x << 24);
+        return x ^ (fold * 0x01010101u) ^ (((x ^ next) << 1) & 0xFEFEFEFEu);
+    }
+}
+
 /**
  * @class CTR_DRBG
  * @brief Counter-mode DRBG based on a simplified AES-like block cipher
@@ -59,20 +106,77 @@ public:
  * version based on AES principles for educational purposes.
  */
 class CTR_DRBG : public DRBG {
+public:
+    /**
+     * @brief Implementation of the SPN rounds used on the generate path
+     *
+     * Both produce identical output; they differ only in speed.
+     */
+    enum class Cipher {
+        Reference,  // Word-oriented rounds with byte-wise S-box lookups; the
+                    // kernel behind encrypt_block() and its known-answer tests
+        TTable,     // SubBytes, permutation and MixColumns merged into 32-bit tables
+        Bitsliced   // AVX2 bit-sliced, 32 blocks at a time, no table lookups;
+                    // falls back to Reference when AVX2 is unavailable
+    };
+
 private:
     static constexpr size_t BLOCK_SIZE = 16;  // 128-bit blocks
     static constexpr size_t KEY_SIZE = 32;    // 256-bit key
+    static constexpr int ROUNDS = 10;
+    static constexpr size_t BLOCK_WORDS = BLOCK_SIZE / 4;
     
     std::array<uint8_t, KEY_SIZE> key;
     std::array<uint8_t, BLOCK_SIZE> counter;
     uint64_t reseed_counter;
     
-    // Simplified block cipher (SPN-based)
-    std::array<uint8_t, BLOCK_SIZE> encrypt_block(const std::array<uint8_t, BLOCK_SIZE>& block);
-    void increment_counter();
+    // Expanded round keys as little-endian 32-bit words, four per round.
+    // Derived from key; rebuilt by expand_key() whenever update() changes it.
+    using RoundKeys = std::array<uint32_t, ROUNDS * BLOCK_WORDS>;
+    RoundKeys round_keys;
+    
+    Cipher cipher;
+    
+    // TTABLES[j][x]: MixColumns of a column holding SBOX[x] in byte j only
+    using TTableSet = std::array<std::array<uint32_t, 256>, 4>;
+    static const TTableSet TTABLES;
+    static constexpr TTableSet make_ttables();
+    
+    // Counter blocks encrypted side by side on the table-based paths, so the
+    // lookups of one block overlap the round-to-round dependency of another
+    static constexpr size_t INTERLEAVE = 4;
+    
+    static constexpr RoundKeys expand_key(const std::array<uint8_t, KEY_SIZE>& key);
+    // Encrypt Lanes consecutive blocks from in to out, rounds interleaved
+    template <size_t Lanes>
+    static constexpr void encrypt_scheduled(const RoundKeys& rk, const uint8_t* in, uint8_t* out);
+    template <size_t Lanes>
+    void encrypt_ttable(const uint8_t* in, uint8_t* out) const;
+    template <size_t Lanes>
+    void encrypt(const uint8_t* in, uint8_t* out) const {
+        if (cipher == Cipher::TTable) {
+            encrypt_ttable<Lanes>(in, out);
+        } else {
+            encrypt_scheduled<Lanes>(round_keys, in, out);
+        }
+    }
+    // Requests shorter than this stay on the calling thread
+    static constexpr size_t PARALLEL_MIN_BLOCKS = 4096;
+    size_t num_threads;
+    
+    // Encrypt the num_blocks counter values after ctr into out (ctr advances)
+    void encrypt_range(std::array<uint8_t, BLOCK_SIZE>& ctr, uint8_t* out, size_t num_blocks) const;
+    // Encrypt the next num_blocks counter values into out (counter advances),
+    // split across num_threads when the request is large enough
+    void keystream(uint8_t* out, size_t num_blocks);
+    static void increment_counter(std::array<uint8_t, BLOCK_SIZE>& ctr);
+    // ctr += blocks, as a 128-bit big-endian integer
+    static void advance_counter(std::array<uint8_t, BLOCK_SIZE>& ctr, uint64_t blocks);
     void update(const std::vector<uint8_t>& provided_data);
     
-    // SPN components
+public:
+    // SPN components (the AES S-box; public so that alternative backends and
+    // compile-time checks can derive from it)
     static constexpr uint8_t SBOX[256] = {
         0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
         0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
@@ -92,11 +196,205 @@ private:
         0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
     };
 
+    /**
+     * @brief Simplified block cipher (SPN-based), usable in constant expressions
+     * @param key 256-bit cipher key
+     * @param block 128-bit plaintext block
+     * @return 128-bit ciphertext block
+     *
+     * Runs the Cipher::Reference kernel, so the compile-time known-answer
+     * tests cover the code that path executes; the other kernels are checked
+     * against it at runtime by SelfTest.
+     */
+    static constexpr std::array<uint8_t, BLOCK_SIZE> encrypt_block(
+        const std::array<uint8_t, KEY_SIZE>& key, const std::array<uint8_t, BLOCK_SIZE>& block);
+
+    explicit CTR_DRBG(const std::vector<uint8_t>& seed, Cipher impl = Cipher::Reference);
+    using DRBG::generate;
+    void generateInto(uint8_t* out, size_t num_bits) override;
+    
+    /**
+     * @brief Fixed-size request (e.g. a 128- or 256-bit key), without heap use
+     * @tparam Bits Number of bits to generate
+     * @return (Bits + 7) / 8 bytes; same output as generate(Bits)
+     */
+    template <size_t Bits>
+    std::array<uint8_t, (Bits + 7) / 8> generate() {
+        constexpr size_t num_blocks = (Bits + 8 * BLOCK_SIZE - 1) / (8 * BLOCK_SIZE);
+        std::array<uint8_t, num_blocks * BLOCK_SIZE> blocks;
+        keystream(blocks.data(), num_blocks);
+        update({});
+        reseed_counter++;
+        
+        std::array<uint8_t, (Bits + 7) / 8> result;
+        std::copy(blocks.begin(), blocks.begin() + result.size(), result.begin());
+        return result;
+    }
+    
+    void reseed(const std::vector<uint8_t>& seed) override;
+    
+    /**
+     * @brief Set the number of threads used for large generate() requests
+     * @param threads Worker count; 0 selects std::thread::hardware_concurrency()
+     *
+     * Counter mode is random access: a request is cut into contiguous counter
+     * ranges, each thread jumps its own copy of the counter ahead to the start
+     * of its range, and the output is identical to the sequential one.
+     * The default of 1 keeps all work on the calling thread.
+     */
+    void setThreadCount(size_t threads);
+    size_t getThreadCount() const { return num_threads; }
+    std::string getName() const override {
+        switch (cipher) {
+            case Cipher::TTable: return "CTR-DRBG-T";
+            case Cipher::Bitsliced: return "CTR-DRBG-BS";
+            default: return "CTR-DRBG";
+        }
+    }
+    size_t getStateSize() const override { return KEY_SIZE + BLOCK_SIZE + sizeof(reseed_counter); }
+};
+
+constexpr CTR_DRBG::RoundKeys CTR_DRBG::expand_key(const std::array<uint8_t, KEY_SIZE>& key) {
+    // Round r uses key bytes (r * BLOCK_SIZE + i) % KEY_SIZE, i.e. the two
+    // key halves alternate
+    RoundKeys rk = {};
+    for (int round = 0; round < ROUNDS; ++round) {
+        size_t offset = (round * BLOCK_SIZE) % KEY_SIZE;
+        for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+            rk[round * BLOCK_WORDS + w] = ctr_drbg_detail::load_le32(&key[offset + w * 4]);
+        }
+    }
+    return rk;
+}
+
+template <size_t Lanes>
+constexpr void CTR_DRBG::encrypt_scheduled(const RoundKeys& rk, const uint8_t* in, uint8_t* out) {
+    using namespace ctr_drbg_detail;
+    
+    // Simple SPN cipher: 10 rounds on four little-endian column words
+    uint32_t s[Lanes][BLOCK_WORDS];
+    for (size_t l = 0; l < Lanes; ++l) {
+        for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+            s[l][w] = load_le32(in + l * BLOCK_SIZE + w * 4);
+        }
+    }
+    
+    for (int round = 0; round < ROUNDS; ++round) {
+        const uint32_t* round_key = &rk[round * BLOCK_WORDS];
+#pragma GCC unroll 4
+        for (size_t l = 0; l < Lanes; ++l) {
+            // Add round key
+            for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                s[l][w] ^= round_key[w];
+            }
+            
+            // SubBytes + ShiftRows: output byte i comes from input byte (i + i/4) % 16
+            uint32_t t[BLOCK_WORDS];
+            for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                t[w] = 0;
+                for (size_t j = 0; j < 4; ++j) {
+                    size_t src = (w * 4 + j + w) % BLOCK_SIZE;
+                    t[w] |= static_cast<uint32_t>(SBOX[byte_of(s[l], src)]) << (8 * j);
+                }
+            }
+            
+            // MixColumns, all four bytes of a column at once; skipped in the last round
+            if (round < ROUNDS - 1) {
+                for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                    t[w] = mix_column(t[w]);
+                }
+            }
+            
+            for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                s[l][w] = t[w];
+            }
+        }
+    }
+    
+    for (size_t l = 0; l < Lanes; ++l) {
+        for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+            store_le32(out + l * BLOCK_SIZE + w * 4, s[l][w]);
+        }
+    }
+}
+
+constexpr std::array<uint8_t, CTR_DRBG::BLOCK_SIZE> CTR_DRBG::encrypt_block(
+    const std::array<uint8_t, KEY_SIZE>& key, const std::array<uint8_t, BLOCK_SIZE>& block) {
+    std::array<uint8_t, BLOCK_SIZE> state = {};
+    encrypt_scheduled<1>(expand_key(key), block.data(), state.data());
+    return state;
+}
+
+/**
+ * @class AES_CTR_DRBG
+ * @brief NIST SP 800-90A CTR_DRBG with AES-256 and a derivation function
+ * 
+ * The standard mechanism, as opposed to the educational SPN in CTR_DRBG:
+ * seed material is condensed with Block_Cipher_df, and the state is the
+ * AES-256 key plus the 128-bit counter V. Encryption uses AES-NI when
+ * available and constant-time software AES otherwise.
+ */
+class AES_CTR_DRBG : public DRBG {
+private:
+    static constexpr size_t BLOCK_SIZE = AES256::BLOCK_SIZE;       // outlen
+    static constexpr size_t KEY_SIZE = AES256::KEY_SIZE;           // keylen
+    static constexpr size_t SEED_LENGTH = KEY_SIZE + BLOCK_SIZE;   // seedlen (384 bits)
+    static constexpr size_t MAX_REQUEST_BYTES = size_t(1) << 16;   // 2^19 bits per request
+    static constexpr uint64_t RESEED_INTERVAL = uint64_t(1) << 48;
+    
+    using SeedMaterial = std::array<uint8_t, SEED_LENGTH>;
+    
+    AES256::Key key;
+    AES256::Block V;
+    uint64_t reseed_counter;
+    
+    // Expanded from key; rebuilt by update() whenever key changes
+    AES256::RoundKeys round_keys;
+    
+    static SeedMaterial block_cipher_df(const std::vector<uint8_t>& input);
+    void update(const SeedMaterial& provided_data);
+    
+    // Instantiates and reseeds through the same derivation function
+    friend class SharedCTR_DRBG;
+
 public:
-    explicit CTR_DRBG(const std::vector<uint8_t>& seed);
-    std::vector<uint8_t> generate(size_t num_bits) override;
+    /**
+     * @param seed entropy_input || nonce || personalization_string
+     */
+    explicit AES_CTR_DRBG(const std::vector<uint8_t>& seed);
+    using DRBG::generate;
+    
+    /**
+     * Requests above the SP 800-90A limit of 2^19 bits are served as a run of
+     * maximum-size requests, each followed by its own state update.
+     */
+    void generateInto(uint8_t* out, size_t num_bits) override;
+    
+    /**
+     * @brief Fixed-size request (at most 2^19 bits), without heap use
+     * @tparam Bits Number of bits to generate
+     * @return (Bits + 7) / 8 bytes; same output as generate(Bits)
+     */
+    template <size_t Bits>
+    std::array<uint8_t, (Bits + 7) / 8> generate() {
+        static_assert(Bits <= MAX_REQUEST_BYTES * 8, "request above the SP 800-90A per-request limit");
+        if (reseed_counter > RESEED_INTERVAL) {
+            throw std::runtime_error("AES_CTR_DRBG: reseed required");
+        }
+        
+        constexpr size_t num_blocks = (Bits + 8 * BLOCK_SIZE - 1) / (8 * BLOCK_SIZE);
+        std::array<uint8_t, num_blocks * BLOCK_SIZE> blocks;
+        AES256::ctrKeystream(round_keys, V.data(), blocks.data(), num_blocks);
+        update(SeedMaterial{});
+        reseed_counter++;
+        
+        std::array<uint8_t, (Bits + 7) / 8> result;
+        std::copy(blocks.begin(), blocks.begin() + result.size(), result.begin());
+        return result;
+    }
+    
     void reseed(const std::vector<uint8_t>& seed) override;
-    std::string getName() const override { return "CTR-DRBG"; }
+    std::string getName() const override { return "AES-CTR-DRBG"; }
     size_t getStateSize() const override { return KEY_SIZE + BLOCK_SIZE + sizeof(reseed_counter); }
 };
 
@@ -111,23 +409,116 @@ public:
     // SHA-256 implementation (public for use by HMAC_DRBG)
     static std::array<uint8_t, 32> sha256(const std::vector<uint8_t>& data);
 
+    /**
+     * @brief Hash_df (SP 800-90A 10.3.1), as used to derive V and C
+     * @param input Input string
+     * @param no_of_bits Number of bits to return
+     * @return (no_of_bits + 7) / 8 derived bytes
+     *
+     * Hashes through the streaming context and so the dispatched SHA-256
+     * kernel; SelfTest checks it against hashDfConst().
+     */
+    static std::vector<uint8_t> hashDf(const std::vector<uint8_t>& input, size_t no_of_bits);
+
+    /**
+     * @brief Compile-time Hash_df (SP 800-90A 10.3.1) over a fixed-size input
+     * @tparam OutBytes Number of output bytes (no_of_bits_to_return / 8)
+     * @param input Input string
+     * @return Derived bytes, computable in constant expressions
+     */
+    template <size_t OutBytes, size_t N>
+    static constexpr std::array<uint8_t, OutBytes> hashDfConst(const std::array<uint8_t, N>& input) {
+        constexpr uint32_t no_of_bits = static_cast<uint32_t>(OutBytes * 8);
+        
+        // counter || no_of_bits (32-bit big-endian) || input
+        std::array<uint8_t, 5 + N> hash_input = {};
+        hash_input[1] = static_cast<uint8_t>((no_of_bits >> 24) & 0xFF);
+        hash_input[2] = static_cast<uint8_t>((no_of_bits >> 16) & 0xFF);
+        hash_input[3] = static_cast<uint8_t>((no_of_bits >> 8) & 0xFF);
+        hash_input[4] = static_cast<uint8_t>(no_of_bits & 0xFF);
+        for (size_t i = 0; i < N; ++i) {
+            hash_input[5 + i] = input[i];
+        }
+        
+        std::array<uint8_t, OutBytes> result = {};
+        uint8_t counter = 1;
+        for (size_t offset = 0; offset < OutBytes; offset += SHA256::DIGEST_SIZE) {
+            hash_input[0] = counter++;
+            auto hash = SHA256::hashConst(hash_input);
+            for (size_t i = 0; i < SHA256::DIGEST_SIZE && offset + i < OutBytes; ++i) {
+                result[offset + i] = hash[i];
+            }
+        }
+        return result;
+    }
+
 private:
     static constexpr size_t SEED_LENGTH = 55;  // seedlen for SHA-256 (440 bits)
     static constexpr size_t HASH_OUTPUT = 32;  // SHA-256 output size
     
-    std::vector<uint8_t> V;  // Internal state
-    std::vector<uint8_t> C;  // Constant value
+    // V and C are big-endian seedlen-byte integers, right-aligned in whole
+    // 64-bit limbs; the leading PAD bytes are always zero
+    static constexpr size_t LIMBS = (SEED_LENGTH + 7) / 8;
+    static constexpr size_t PAD = LIMBS * 8 - SEED_LENGTH;
+    using LimbBuffer = std::array<uint8_t, LIMBS * 8>;
+    
+    LimbBuffer V;  // Internal state
+    LimbBuffer C;  // Constant value
     uint64_t reseed_counter;
-    std::vector<uint8_t> hash_df(const std::vector<uint8_t>& input, size_t no_of_bits);
-    std::vector<uint8_t> hashgen(size_t requested_bits);
-    void add_to_V(const std::vector<uint8_t>& value);
+    // Requests shorter than this many blocks stay on the calling thread
+    static constexpr size_t PARALLEL_MIN_BLOCKS = 1024;
+    size_t num_threads;
+    
+    const uint8_t* v_bytes() const { return V.data() + PAD; }
+    
+    // V = Hash_df(seed_material), C = Hash_df(0x00 || V)
+    void derive_state(const std::vector<uint8_t>& seed_material);
+    void hashgen(uint8_t* out, size_t requested_bits);
+    // Post-request update: V = V + Hash(0x03 || V) + C + reseed_counter
+    void update_state();
+    // Hash(v + first), Hash(v + first + 1), ... for num_blocks blocks into out
+    static void hashgen_range(const uint8_t* v, uint64_t first, uint8_t* out, size_t num_blocks);
+    // Add blocks to the seedlen-byte big-endian integer at data
+    static void offset_data(uint8_t* data, uint64_t blocks);
+    // V = (V + H + C + reseed_counter) mod 2^seedlen, in one pass over the limbs
+    void update_V(const SHA256::Digest& H);
 
 public:
     explicit Hash_DRBG(const std::vector<uint8_t>& seed);
-    std::vector<uint8_t> generate(size_t num_bits) override;
+    using DRBG::generate;
+    void generateInto(uint8_t* out, size_t num_bits) override;
+    
+    /**
+     * @brief Fixed-size request (e.g. a 128- or 256-bit key), without heap use
+     * @tparam Bits Number of bits to generate
+     * @return (Bits + 7) / 8 bytes; same output as generate(Bits)
+     */
+    template <size_t Bits>
+    std::array<uint8_t, (Bits + 7) / 8> generate() {
+        constexpr size_t num_blocks = (Bits + 8 * HASH_OUTPUT - 1) / (8 * HASH_OUTPUT);
+        std::array<uint8_t, num_blocks * HASH_OUTPUT> blocks;
+        hashgen_range(v_bytes(), 0, blocks.data(), num_blocks);
+        update_state();
+        
+        std::array<uint8_t, (Bits + 7) / 8> result;
+        std::copy(blocks.begin(), blocks.begin() + result.size(), result.begin());
+        return result;
+    }
+    
     void reseed(const std::vector<uint8_t>& seed) override;
+    
+    /**
+     * @brief Set the number of threads used by hashgen for large requests
+     * @param threads Worker count; 0 selects std::thread::hardware_concurrency()
+     *
+     * Output block i is Hash(V + i), so each thread starts from V plus the
+     * index of its first block; the bytes are the same as the sequential run,
+     * and the state update afterwards is unchanged.
+     */
+    void setThreadCount(size_t threads);
+    size_t getThreadCount() const { return num_threads; }
     std::string getName() const override { return "Hash-DRBG"; }
-    size_t getStateSize() const override { return V.size() + C.size() + sizeof(reseed_counter); }
+    size_t getStateSize() const override { return 2 * SEED_LENGTH + sizeof(reseed_counter); }
 };
 
 /**
@@ -144,15 +535,42 @@ private:
     std::array<uint8_t, HASH_OUTPUT> V;  // Value
     uint64_t reseed_counter;
     
-    // HMAC-SHA256 implementation
-    static std::array<uint8_t, 32> hmac_sha256(const std::array<uint8_t, 32>& key, 
-                                                const std::vector<uint8_t>& data);
-    static std::array<uint8_t, 32> sha256(const std::vector<uint8_t>& data);
+    // HMAC keyed with K: inner/outer SHA-256 midstates after the ipad/opad
+    // blocks. Rebuilt only when K changes, so each HMAC(K, .) that follows
+    // costs two compressions instead of four.
+    HMAC_SHA256 keyed_mac;
+    
+    void set_key(const std::array<uint8_t, HASH_OUTPUT>& new_key);
     void update(const std::vector<uint8_t>& provided_data);
 
 public:
     explicit HMAC_DRBG(const std::vector<uint8_t>& seed);
-    std::vector<uint8_t> generate(size_t num_bits) override;
+    using DRBG::generate;
+    void generateInto(uint8_t* out, size_t num_bits) override;
+    
+    /**
+     * @brief Fixed-size request (e.g. a 128- or 256-bit key), without heap use
+     * @tparam Bits Number of bits to generate
+     * @return (Bits + 7) / 8 bytes; same output as generate(Bits)
+     */
+    template <size_t Bits>
+    std::array<uint8_t, (Bits + 7) / 8> generate() {
+        constexpr size_t num_bytes = (Bits + 7) / 8;
+        std::array<uint8_t, num_bytes> result;
+        
+        // Trip count is a compile-time constant: one HMAC per 32 bytes
+        for (size_t offset = 0; offset < num_bytes; offset += HASH_OUTPUT) {
+            HMAC_SHA256 mac = keyed_mac;
+            mac.update(V);
+            V = mac.finalize();
+            std::copy(V.begin(), V.begin() + std::min(HASH_OUTPUT, num_bytes - offset), result.begin() + offset);
+        }
+        
+        update({});
+        reseed_counter++;
+        return result;
+    }
+    
     void reseed(const std::vector<uint8_t>& seed) override;
     std::string getName() const override { return "HMAC-DRBG"; }
     size_t getStateSize() const override { return sizeof(K) + sizeof(V) + sizeof(reseed_counter); }
@@ -0,0 +1,210 @@
+/**
+ * @file drbg_pool.hpp
+ * @brief Sharded DRBG pool: one lazily created instance per thread or per core
+ *
+ * The DRBG classes keep mutable state and are not thread-safe. Instead of
+ * serializing every caller on one lock, DRBGPool gives each thread (or each
+ * core) its own instance, seeded from a master DRBG with a personalization
+ * string that names the shard. Instances live inline in cache-line-aligned
+ * slots, so shards used by different threads never share a line.
+ */
+
+#ifndef DRBG_POOL_HPP
+#define DRBG_POOL_HPP
+
+#include "drbg.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace drbg_pool_detail {
+    constexpr size_t CACHE_LINE = 64;
+    constexpr size_t SEED_BYTES = 48;
+
+    // Pool ids are unique across all pools and stay registered while the
+    // pool lives. Each unregister bumps destroyed_pools, which tells threads
+    // to drop their entries for pools that are gone.
+    uint64_t register_pool();
+    void unregister_pool(uint64_t pool_id);
+    bool pool_alive(uint64_t pool_id);
+    inline std::atomic<uint64_t> destroyed_pools{0};
+
+    // CPU the calling thread is running on (a thread-id hash where unknown)
+    size_t current_cpu();
+
+    /**
+     * @brief Seed material for one shard: master output XOR personalization
+     *
+     * The personalization string is "DRBGPool/shard/" followed by the shard
+     * index as 8 big-endian bytes, XORed into the leading bytes of the
+     * master output as in SP 800-90A 10.2.1.3.1. CTR_DRBG only reads
+     * SEED_BYTES of seed, so appending would drop the string.
+     */
+    std::vector<uint8_t> shard_seed(DRBG& master, uint64_t shard);
+}
+
+/**
+ * @class DRBGPool
+ * @brief Thread-safe DRBG facade over per-thread or per-core instances of D
+ * @tparam D Concrete DRBG class, stored inline in each shard
+ *
+ * PerThread gives every calling thread a private instance on first use, with
+ * no locking afterwards; slots stay allocated until the pool is destroyed.
+ * PerCore keeps one instance per hardware thread, picked by the CPU the
+ * caller runs on and guarded by a per-slot mutex, which is uncontended
+ * unless threads migrate mid-call. reseed() reseeds the master and each
+ * shard rederives its state on its next request.
+ */
+template <typename D>
+class DRBGPool : public DRBG {
+public:
+    enum class Sharding { PerThread, PerCore };
+    using Factory = std::function<D(const std::vector<uint8_t>&)>;
+
+    /**
+     * @param seed Seed for the master DRBG
+     * @param mode Shard per thread or per core
+     * @param factory Builds an instance from seed material (e.g. to pick a
+     *                CTR_DRBG cipher); defaults to D(seed)
+     */
+    explicit DRBGPool(const std::vector<uint8_t>& seed, Sharding mode = Sharding::PerThread,
+                      Factory factory = [](const std::vector<uint8_t>& s) { return D(s); })
+        : make(std::move(factory)), master(make(seed)), sharding(mode),
+          pool_id(drbg_pool_detail::register_pool()), epoch(1) {
+        if (sharding == Sharding::PerCore) {
+            size_t cores = std::max(1u, std::thread::hardware_concurrency());
+            for (size_t i = 0; i < cores; ++i) {
+                slots.push_back(std::make_unique<Slot>(i));
+            }
+        }
+    }
+
+    ~DRBGPool() override { drbg_pool_detail::unregister_pool(pool_id); }
+
+    using DRBG::generate;
+
+    void generateInto(uint8_t* out, size_t num_bits) override {
+        with_shard([&](D& drbg) { drbg.generateInto(out, num_bits); });
+    }
+
+    /**
+     * @brief Fixed-size request served by the shard's D::generate<Bits>()
+     */
+    template <size_t Bits>
+    std::array<uint8_t, (Bits + 7) / 8> generate() {
+        std::array<uint8_t, (Bits + 7) / 8> result;
+        with_shard([&](D& drbg) { result = drbg.template generate<Bits>(); });
+        return result;
+    }
+
+    void reseed(const std::vector<uint8_t>& seed) override {
+        std::lock_guard<std::mutex> guard(master_lock);
+        master.reseed(seed);
+        epoch.fetch_add(1, std::memory_order_release);
+    }
+
+    std::string getName() const override { return master.getName() + "/pool"; }
+
+    // Master plus every shard created so far
+    size_t getStateSize() const override {
+        return master.getStateSize() * (1 + shardCount());
+    }
+
+    /**
+     * @brief Number of shard slots allocated so far
+     */
+    size_t shardCount() const {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        return slots.size();
+    }
+
+private:
+    struct alignas(drbg_pool_detail::CACHE_LINE) Slot {
+        explicit Slot(uint64_t shard_index) : index(shard_index) {}
+        std::optional<D> drbg;
+        uint64_t epoch = 0;      // Master epoch the instance was derived in
+        const uint64_t index;    // Shard number in the personalization string
+        std::mutex lock;         // PerCore only
+    };
+
+    struct ThreadEntry {
+        uint64_t pool_id;
+        Slot* slot;
+    };
+
+    // One thread's slots, one entry per live pool of this type it has used
+    struct ThreadEntries {
+        std::vector<ThreadEntry> entries;
+        uint64_t pruned_at = 0;  // destroyed_pools as of the last pruning
+    };
+
+    Factory make;
+    D master;
+    std::mutex master_lock;
+    const Sharding sharding;
+    const uint64_t pool_id;
+    std::atomic<uint64_t> epoch;
+
+    mutable std::mutex registry_lock;
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    // Rederive the slot's instance if it is missing or predates a reseed
+    void refresh(Slot& slot) {
+        uint64_t current = epoch.load(std::memory_order_acquire);
+        if (slot.drbg && slot.epoch == current) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(master_lock);
+        slot.drbg.emplace(make(drbg_pool_detail::shard_seed(master, slot.index)));
+        slot.epoch = epoch.load(std::memory_order_relaxed);
+    }
+
+    // This thread's slot, registered on first use
+    Slot& thread_slot() {
+        static thread_local ThreadEntries local;
+        
+        // Drop entries of pools destroyed since the last lookup, so a
+        // long-lived thread's list stays as short as its set of live pools
+        uint64_t destroyed = drbg_pool_detail::destroyed_pools.load(std::memory_order_acquire);
+        if (local.pruned_at != destroyed) {
+            std::erase_if(local.entries, [](const ThreadEntry& entry) {
+                return !drbg_pool_detail::pool_alive(entry.pool_id);
+            });
+            local.pruned_at = destroyed;
+        }
+        
+        for (const ThreadEntry& entry : local.entries) {
+            if (entry.pool_id == pool_id) {
+                return *entry.slot;
+            }
+        }
+        std::lock_guard<std::mutex> guard(registry_lock);
+        slots.push_back(std::make_unique<Slot>(slots.size()));
+        local.entries.push_back({pool_id, slots.back().get()});
+        return *slots.back();
+    }
+
+    template <typename Fn>
+    void with_shard(Fn&& fn) {
+        if (sharding == Sharding::PerThread) {
+            Slot& slot = thread_slot();
+            refresh(slot);
+            fn(*slot.drbg);
+        } else {
+            Slot& slot = *slots[drbg_pool_detail::current_cpu() % slots.size()];
+            std::lock_guard<std::mutex> guard(slot.lock);
+            refresh(slot);
+            fn(*slot.drbg);
+        }
+    }
+};
+
+#endif // DRBG_POOL_HPP
@@ -0,0 +1,141 @@
+/**
+ * @file drbg_prefetcher.hpp
+ * @brief Background producer that keeps DRBG output ready in a lock-free ring
+ *
+ * A request normally pays for the generate call and the state update that
+ * follows it. DRBGPrefetcher moves both onto a dedicated producer thread,
+ * which fills a ring of fixed-size slots ahead of demand; a consumer claims
+ * a filled slot with a compare-and-swap, copies it out and zeroes it. The
+ * producer refills when the ring drops to a low watermark and sleeps once it
+ * reaches the high watermark.
+ */
+
+#ifndef DRBG_PREFETCHER_HPP
+#define DRBG_PREFETCHER_HPP
+
+#include "drbg.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class DRBGPrefetcher
+ * @brief Thread-safe DRBG facade serving requests from prefetched output
+ *
+ * The ring is a bounded queue in the style of Vyukov's MPMC queue, with the
+ * single producer publishing each slot through a per-slot sequence number.
+ * Any number of threads may call generateInto(). A request that finds the
+ * ring empty does not wait for the producer: it takes the source lock and
+ * generates the rest directly. Requests larger than MAX_PREFETCHED_BYTES
+ * always go to the source, since the ring exists for small, latency-bound
+ * requests.
+ *
+ * The source DRBG must outlive the prefetcher and must not be used by
+ * anything else while it exists.
+ */
+class DRBGPrefetcher : public DRBG {
+public:
+    // One 256-bit key or nonce per slot; with the sequence number that is
+    // 40 bytes, padded to a cache line of its own
+    static constexpr size_t SLOT_BYTES = 32;
+    static constexpr size_t DEFAULT_SLOTS = 1024;
+    static constexpr size_t MAX_PREFETCHED_BYTES = 8 * SLOT_BYTES;
+
+    /**
+     * @param source DRBG to prefetch from
+     * @param num_slots Ring capacity (rounded up to a power of two); the
+     *                  watermarks default to a quarter and all of it
+     */
+    explicit DRBGPrefetcher(DRBG& source, size_t num_slots = DEFAULT_SLOTS);
+
+    /**
+     * @param source DRBG to prefetch from
+     * @param num_slots Ring capacity (rounded up to a power of two)
+     * @param low_watermark Producer wakes when at most this many slots are filled
+     * @param high_watermark Producer sleeps once this many slots are filled
+     * @throws std::invalid_argument unless low_watermark < high_watermark <= capacity
+     */
+    DRBGPrefetcher(DRBG& source, size_t num_slots, size_t low_watermark, size_t high_watermark);
+
+    // Stops the producer and wipes every slot
+    ~DRBGPrefetcher() override;
+
+    DRBGPrefetcher(const DRBGPrefetcher&) = delete;
+    DRBGPrefetcher& operator=(const DRBGPrefetcher&) = delete;
+
+    /**
+     * Takes ceil(bytes / SLOT_BYTES) slots; the unused tail of the last one
+     * is wiped along with the rest of it.
+     */
+    void generateInto(uint8_t* out, size_t num_bits) override;
+
+    /**
+     * @brief Reseed the source and wipe everything prefetched before it
+     */
+    void reseed(const std::vector<uint8_t>& seed) override;
+
+    std::string getName() const override { return source.getName() + "/prefetch"; }
+
+    // Source state plus the ring, whose contents are future output
+    size_t getStateSize() const override {
+        return source.getStateSize() + capacity * sizeof(Slot);
+    }
+
+    size_t capacitySlots() const { return capacity; }
+
+    /**
+     * @brief Filled slots waiting in the ring (a snapshot)
+     */
+    size_t available() const;
+
+    /**
+     * @brief Requests that found the ring empty and went to the source
+     */
+    uint64_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+
+private:
+    // Slots generated per producer call to the source
+    static constexpr size_t BATCH_SLOTS = 64;
+
+    // One slot per cache line, so neighbouring positions never false-share
+    struct alignas(64) Slot {
+        // pos + 1 once filled for position pos; pos + capacity once consumed
+        std::atomic<uint64_t> sequence;
+        uint8_t data[SLOT_BYTES];
+    };
+    static_assert(sizeof(Slot) == 64, "a slot must occupy exactly one cache line");
+
+    DRBG& source;
+    const size_t capacity;
+    const size_t low;
+    const size_t high;
+    std::unique_ptr<Slot[]> slots;
+
+    // Consumers and producer each own a line
+    alignas(64) std::atomic<uint64_t> head;  // Next position to consume
+    alignas(64) std::atomic<uint64_t> tail;  // Next position to fill
+    std::atomic<uint64_t> miss_count;
+
+    std::mutex source_lock;    // Held around every call into source
+    std::mutex wake_lock;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stopping;
+    std::thread producer;
+
+    // Copy the next filled slot's first num_bytes out and free it; false if empty
+    bool take(uint8_t* out, size_t num_bytes);
+
+    // Generate count slots in one request and publish them
+    void fill(uint8_t* batch, size_t count);
+
+    void produce();
+    void wake_if_low();
+};
+
+#endif // DRBG_PREFETCHER_HPP
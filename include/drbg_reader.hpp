@@ -0,0 +1,86 @@
+/**
+ * @file drbg_reader.hpp
+ * @brief Buffered typed draws (uint32, uint64, bytes) on top of any DRBG
+ *
+ * Every DRBG request ends with a state update, which costs more than the
+ * output itself when the request is a single integer. DRBGReader refills a
+ * block-aligned buffer with one large request and serves draws from it.
+ * Bytes are zeroed as soon as they are handed out, so a later compromise of
+ * the reader cannot recover output that was already consumed.
+ */
+
+#ifndef DRBG_READER_HPP
+#define DRBG_READER_HPP
+
+#include "drbg.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @class DRBGReader
+ * @brief Serves small typed draws from a buffered DRBG request
+ *
+ * Not thread-safe: each thread should use its own reader.
+ */
+class DRBGReader {
+public:
+    // Buffer sizes are rounded up to this: a whole number of 16-byte cipher
+    // blocks and 32-byte hash blocks, and of cache lines
+    static constexpr size_t BUFFER_ALIGN = 64;
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 4096;
+
+    /**
+     * @param drbg Source generator; must outlive the reader
+     * @param buffer_bytes Bytes fetched per refill (rounded up to BUFFER_ALIGN)
+     */
+    explicit DRBGReader(DRBG& drbg, size_t buffer_bytes = DEFAULT_BUFFER_BYTES);
+    ~DRBGReader();
+
+    DRBGReader(const DRBGReader&) = delete;
+    DRBGReader& operator=(const DRBGReader&) = delete;
+
+    uint32_t nextUint32() { return next<uint32_t>(); }
+    uint64_t nextUint64() { return next<uint64_t>(); }
+
+    // UniformRandomBitGenerator interface, so a reader can drive <random>
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type{0}; }
+    result_type operator()() { return nextUint64(); }
+
+    /**
+     * @brief Fill out with num_bytes random bytes
+     *
+     * Whole buffers' worth of a large request go straight to the DRBG.
+     */
+    void readBytes(uint8_t* out, size_t num_bytes);
+
+    /**
+     * @brief Wipe and drop buffered output, e.g. after the DRBG is reseeded
+     */
+    void discard();
+
+    size_t bufferSize() const { return buffer.size(); }
+
+private:
+    DRBG& drbg;
+    std::vector<uint8_t> buffer;
+    size_t position;  // First unread byte; buffer.size() when empty
+
+    void refill();
+
+    template <typename T>
+    T next() {
+        if (buffer.size() - position < sizeof(T)) {
+            refill();
+        }
+        T value;
+        std::memcpy(&value, &buffer[position], sizeof(T));
+        std::memset(&buffer[position], 0, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+};
+
+#endif // DRBG_READER_HPP
@@ -0,0 +1,51 @@
+/**
+ * @file kat.hpp
+ * @brief constexpr helpers for compile-time known-answer tests
+ */
+
+#ifndef KAT_HPP
+#define KAT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace kat {
+
+/**
+ * @brief Bytes of a string literal, without the terminating NUL
+ */
+template <size_t M>
+constexpr std::array<uint8_t, M - 1> bytes(const char (&text)[M]) {
+    std::array<uint8_t, M - 1> result = {};
+    for (size_t i = 0; i + 1 < M; ++i) {
+        result[i] = static_cast<uint8_t>(text[i]);
+    }
+    return result;
+}
+
+constexpr int hexDigit(char c) {
+    return (c >= '0' && c <= '9') ? c - '0'
+         : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+         : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+         : -1;
+}
+
+/**
+ * @brief Compare a byte array against a hex string of exactly twice its length
+ */
+template <size_t N>
+constexpr bool matchesHex(const std::array<uint8_t, N>& value, const char (&hex)[2 * N + 1]) {
+    for (size_t i = 0; i < N; ++i) {
+        int hi = hexDigit(hex[2 * i]);
+        int lo = hexDigit(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0 || value[i] != ((hi << 4) | lo)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace kat
+
+#endif // KAT_HPP
@@ -0,0 +1,170 @@
+/**
+ * @file locked_drbg.hpp
+ * @brief Thread-safe DRBG wrappers: one lock (mutex or spinlock) or N locked shards
+ *
+ * The simplest way to share a DRBG is to put a lock around it. LockedDRBG
+ * does that with any BasicLockable type, SpinLock is an adaptive spinlock
+ * for short requests, and ShardedDRBG spreads threads over N independently
+ * locked instances so that each lock sees only a fraction of the traffic.
+ */
+
+#ifndef LOCKED_DRBG_HPP
+#define LOCKED_DRBG_HPP
+
+#include "drbg.hpp"
+#include "drbg_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace locked_drbg_detail {
+    // Well-mixed hash of the calling thread's id, computed once per thread
+    // (std::hash<std::thread::id> is often the raw, highly aligned pthread_t)
+    size_t thread_hash();
+}
+
+/**
+ * @class SpinLock
+ * @brief Test-and-test-and-set lock that spins briefly, then yields
+ *
+ * Like glibc's adaptive mutex, the spin budget follows a running average of
+ * how long recent acquisitions had to spin, capped at MAX_SPINS; past the
+ * budget a waiter yields its time slice. On a single CPU it never spins,
+ * since the holder cannot release the lock while the waiter runs.
+ */
+class SpinLock {
+public:
+    void lock() {
+        if (!locked.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        lock_contended();
+    }
+
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) &&
+               !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+
+private:
+    static constexpr int MAX_SPINS = 1000;
+
+    alignas(drbg_pool_detail::CACHE_LINE) std::atomic<bool> locked{false};
+    std::atomic<int> spin_estimate{0};  // Written only by the holder
+
+    void lock_contended();
+};
+
+/**
+ * @class LockedDRBG
+ * @brief Serializes every call into a DRBG behind one Lock
+ * @tparam Lock BasicLockable type, e.g. std::mutex or SpinLock
+ */
+template <typename Lock>
+class LockedDRBG : public DRBG {
+public:
+    /**
+     * @param drbg Wrapped generator; must outlive this object and must not
+     *             be used directly while it exists
+     */
+    explicit LockedDRBG(DRBG& drbg) : drbg(drbg) {}
+
+    void generateInto(uint8_t* out, size_t num_bits) override {
+        std::lock_guard<Lock> guard(lock);
+        drbg.generateInto(out, num_bits);
+    }
+
+    void reseed(const std::vector<uint8_t>& seed) override {
+        std::lock_guard<Lock> guard(lock);
+        drbg.reseed(seed);
+    }
+
+    std::string getName() const override { return drbg.getName(); }
+    size_t getStateSize() const override { return drbg.getStateSize(); }
+
+private:
+    DRBG& drbg;
+    Lock lock;
+};
+
+using MutexDRBG = LockedDRBG<std::mutex>;
+using SpinLockDRBG = LockedDRBG<SpinLock>;
+
+/**
+ * @class ShardedDRBG
+ * @brief N instances of D, each behind its own Lock, picked by thread-id hash
+ * @tparam D Concrete DRBG class, stored inline in each shard
+ * @tparam Lock BasicLockable type guarding one shard
+ *
+ * Shards are seeded up front from a master D, with the same personalization
+ * as DRBGPool shards. Unlike DRBGPool, the shard count is fixed and
+ * independent of the number of threads: several threads may hash to the
+ * same shard and then contend for its lock. reseed() reseeds the master and
+ * rederives every shard before returning.
+ */
+template <typename D, typename Lock = std::mutex>
+class ShardedDRBG : public DRBG {
+public:
+    using Factory = std::function<D(const std::vector<uint8_t>&)>;
+
+    /**
+     * @param seed Seed for the master DRBG
+     * @param num_shards Shard count; 0 selects four per hardware thread
+     * @param factory Builds an instance from seed material; defaults to D(seed)
+     */
+    explicit ShardedDRBG(const std::vector<uint8_t>& seed, size_t num_shards = 0,
+                         Factory factory = [](const std::vector<uint8_t>& s) { return D(s); })
+        : make(std::move(factory)), master(make(seed)) {
+        if (num_shards == 0) {
+            num_shards = 4 * std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards.push_back(std::make_unique<Shard>());
+            shards.back()->drbg.emplace(make(drbg_pool_detail::shard_seed(master, i)));
+        }
+    }
+
+    using DRBG::generate;
+
+    void generateInto(uint8_t* out, size_t num_bits) override {
+        Shard& shard = *shards[locked_drbg_detail::thread_hash() % shards.size()];
+        std::lock_guard<Lock> guard(shard.lock);
+        shard.drbg->generateInto(out, num_bits);
+    }
+
+    void reseed(const std::vector<uint8_t>& seed) override {
+        std::lock_guard<std::mutex> guard(master_lock);
+        master.reseed(seed);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            std::lock_guard<Lock> shard_guard(shards[i]->lock);
+            shards[i]->drbg.emplace(make(drbg_pool_detail::shard_seed(master, i)));
+        }
+    }
+
+    std::string getName() const override { return master.getName() + "/sharded"; }
+    size_t getStateSize() const override { return master.getStateSize() * (1 + shards.size()); }
+
+    size_t shardCount() const { return shards.size(); }
+
+private:
+    struct alignas(drbg_pool_detail::CACHE_LINE) Shard {
+        std::optional<D> drbg;
+        Lock lock;
+    };
+
+    Factory make;
+    D master;
+    std::mutex master_lock;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+#endif // LOCKED_DRBG_HPP
@@ -0,0 +1,211 @@
+/**
+ * @file sampling.hpp
+ * @brief Fisher-Yates shuffling and reservoir sampling driven by a DRBG
+ *
+ * Both routines read their randomness through a DRBGReader, so one large
+ * generate call serves thousands of draws. Shuffle indices are produced a
+ * chunk at a time before any element moves, which also lets the swap loop
+ * prefetch the elements it is about to touch.
+ */
+
+#ifndef SAMPLING_HPP
+#define SAMPLING_HPP
+
+#include "drbg.hpp"
+#include "drbg_reader.hpp"
+#include "distributions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Sampling
+ * @brief Uniform random permutations and k-of-n samples
+ */
+class Sampling {
+public:
+    /**
+     * @brief Shuffle data[0..n) into a uniformly random order
+     * @param drbg Source of randomness
+     * @param data Array to permute in place
+     * @param n Number of elements
+     *
+     * Arrays of trivially copyable elements larger than the last-level cache
+     * are shuffled in blocks (see blockedShuffle()); everything else takes
+     * the Fisher-Yates path.
+     */
+    template <typename T>
+    static void shuffle(DRBG& drbg, T* data, size_t n) {
+        if (n < 2) {
+            return;
+        }
+        // About four bytes of randomness per element; small arrays need no more
+        DRBGReader rng(drbg, std::min(SHUFFLE_BUFFER_BYTES, n * sizeof(uint32_t)));
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>) {
+            if (n * sizeof(T) > blockedShuffleThreshold()) {
+                blockedShuffle(rng, data, n);
+                return;
+            }
+        }
+        fisherYates(rng, data, n);
+    }
+
+    /**
+     * @brief Draw k items uniformly without replacement from [first, last)
+     * @param drbg Source of randomness
+     * @param out Destination for min(k, n) items, in no particular order
+     * @return Number of items written
+     *
+     * Li's Algorithm L: after the reservoir fills, the gap to the next
+     * replacement is drawn from its geometric distribution, so only
+     * O(k log(n / k)) random draws are made. Random-access ranges jump over
+     * the gap; other iterators step through it.
+     */
+    template <typename InputIt, typename T>
+    static size_t reservoirSample(DRBG& drbg, InputIt first, InputIt last, T* out, size_t k) {
+        size_t filled = 0;
+        for (; filled < k && first != last; ++first) {
+            out[filled++] = *first;
+        }
+        if (filled < k || first == last || k == 0) {
+            return filled;
+        }
+
+        DRBGReader rng(drbg);
+        double w = std::exp(std::log(openUnit(rng)) / k);
+        for (;;) {
+            double gap = std::floor(std::log(openUnit(rng)) / std::log1p(-w));
+            size_t skip = (gap < static_cast<double>(std::numeric_limits<size_t>::max()))
+                ? static_cast<size_t>(gap) : std::numeric_limits<size_t>::max();
+
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+                if (skip >= static_cast<size_t>(last - first)) {
+                    return k;
+                }
+                first += skip;
+            } else {
+                for (; skip > 0 && first != last; --skip) {
+                    ++first;
+                }
+                if (first == last) {
+                    return k;
+                }
+            }
+
+            out[Uniform::below64(rng, k)] = *first;
+            ++first;
+            w *= std::exp(std::log(openUnit(rng)) / k);
+        }
+    }
+
+    /**
+     * @brief Swap targets for Fisher-Yates steps top, top - 1, ...
+     * @param rng Source of random words
+     * @param top Highest index still to be placed
+     * @param count Number of steps (at most top)
+     * @param out out[s] is uniform in [0, top - s]
+     *
+     * While both bounds fit in 32 bits, two consecutive steps share one
+     * 64-bit word (Brackett-Rozinsky & Lemire, "Batched Ranged Random
+     * Integer Generation", 2024): the word is multiplied by each bound in
+     * turn, and the pair is redrawn only if the final low half falls below
+     * 2^64 mod (product of the bounds).
+     */
+    static void swapTargets(DRBGReader& rng, uint64_t top, size_t count, uint64_t* out);
+
+    /**
+     * @brief Array size in bytes above which shuffle() switches to blocks
+     * @return The last-level cache size, or 32 MiB if the CPU does not report one
+     */
+    static size_t blockedShuffleThreshold();
+
+private:
+    static constexpr size_t SHUFFLE_BUFFER_BYTES = 64 * 1024;
+    static constexpr size_t SWAP_CHUNK = 1024;
+    static constexpr size_t PREFETCH_DISTANCE = 16;
+    // Blocked shuffle: each block should fit comfortably in L2
+    static constexpr size_t BLOCK_BYTES = 512 * 1024;
+    static constexpr size_t MAX_BLOCKS = 1 << 16;
+
+    /**
+     * Block ids uniform in [0, num_blocks), packed several per 64-bit word
+     * with the same batched multiply as swapTargets(): as many as keep the
+     * product of the bounds at most 2^56, so a word is redrawn at most
+     * 1/256 of the time. That is about 56 / log2(num_blocks) ids: five or
+     * more up to 2^11 blocks, three at MAX_BLOCKS.
+     */
+    static void fillBlockIds(DRBGReader& rng, uint32_t num_blocks, uint16_t* out, size_t count);
+
+    // Uniform double in (0, 1], safe to take the log of
+    static double openUnit(DRBGReader& rng) {
+        return 1.0 - Uniform::unitDouble(rng);
+    }
+
+    template <typename T>
+    static void fisherYates(DRBGReader& rng, T* data, size_t n) {
+        uint64_t targets[SWAP_CHUNK];
+        for (size_t top = n - 1; top > 0;) {
+            size_t count = std::min(SWAP_CHUNK, top);
+            swapTargets(rng, top, count, targets);
+            for (size_t s = 0; s < count; ++s) {
+                if (s + PREFETCH_DISTANCE < count) {
+                    __builtin_prefetch(&data[targets[s + PREFETCH_DISTANCE]], 1);
+                }
+                using std::swap;
+                swap(data[top - s], data[targets[s]]);
+            }
+            top -= count;
+        }
+    }
+
+    /**
+     * Sanders' two-level shuffle ("Random permutations on distributed,
+     * external and hierarchical memory", 1998): every element goes to a
+     * uniformly random block, the blocks are concatenated, and each block is
+     * shuffled on its own. The result is a uniform permutation, but the
+     * random-access swaps now stay inside a cache-sized block and the
+     * scatter pass writes to a few hundred sequential streams. Costs a copy
+     * of the array plus two bytes per element, and about 1.5 extra random
+     * bytes per element for the block ids.
+     */
+    template <typename T>
+    static void blockedShuffle(DRBGReader& rng, T* data, size_t n) {
+        size_t num_blocks = std::min(MAX_BLOCKS, (n * sizeof(T) + BLOCK_BYTES - 1) / BLOCK_BYTES);
+        // Default-initialized: both arrays are fully written before being read
+        std::unique_ptr<uint16_t[]> block_of(new uint16_t[n]);
+        std::vector<size_t> start(num_blocks + 1, 0);
+
+        fillBlockIds(rng, static_cast<uint32_t>(num_blocks), block_of.get(), n);
+        for (size_t i = 0; i < n; ++i) {
+            start[block_of[i] + 1]++;
+        }
+        for (size_t b = 0; b < num_blocks; ++b) {
+            start[b + 1] += start[b];
+        }
+
+        std::unique_ptr<T[]> scratch(new T[n]);
+        std::vector<size_t> next(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            scratch[next[block_of[i]]++] = data[i];
+        }
+        // Each block is copied back right after its shuffle, while still cached
+        for (size_t b = 0; b < num_blocks; ++b) {
+            T* block = scratch.get() + start[b];
+            size_t size = start[b + 1] - start[b];
+            if (size > 1) {
+                fisherYates(rng, block, size);
+            }
+            std::copy(block, block + size, data + start[b]);
+        }
+    }
+};
+
+#endif // SAMPLING_HPP
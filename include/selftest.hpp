@@ -0,0 +1,39 @@
+/**
+ * @file selftest.hpp
+ * @brief Runtime checks of the accelerated kernels against their references
+ *
+ * The static_assert known-answer tests pin the constexpr reference code.
+ * The kernels picked at runtime run different code, and which of them run
+ * depends on the CPU, so they are compared against those references here,
+ * on the machine at hand.
+ */
+
+#ifndef SELFTEST_HPP
+#define SELFTEST_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct SelfTestResult
+ * @brief Outcome of one fast-path-vs-reference comparison
+ */
+struct SelfTestResult {
+    std::string name;
+    bool passed;
+};
+
+/**
+ * @class SelfTest
+ * @brief Compares every accelerated path with the reference it must match
+ */
+class SelfTest {
+public:
+    /**
+     * @brief Run every check
+     * @return One result per check, in a fixed order
+     */
+    static std::vector<SelfTestResult> runAll();
+};
+
+#endif // SELFTEST_HPP
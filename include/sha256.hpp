@@ -0,0 +1,308 @@
+/**
+ * @file sha256.hpp
+ * @brief Incremental SHA-256 and HMAC-SHA256 contexts
+ *
+ * The contexts absorb their input piecewise (init/update/finalize), so the
+ * DRBGs can hash prefixes, counters and state without first concatenating
+ * them into temporary buffers.
+ */
+
+#ifndef SHA256_HPP
+#define SHA256_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <string>
+#include <utility>
+
+namespace sha256_detail {
+    // SHA-256 round constants
+    inline constexpr uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+        0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+        0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+        0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+        0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+        0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    constexpr uint32_t rotr(uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    constexpr uint32_t ch(uint32_t x, uint32_t y, uint32_t z) {
+        return (x & y) ^ (~x & z);
+    }
+
+    constexpr uint32_t maj(uint32_t x, uint32_t y, uint32_t z) {
+        return (x & y) ^ (x & z) ^ (y & z);
+    }
+
+    constexpr uint32_t sigma0(uint32_t x) {
+        return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22);
+    }
+
+    constexpr uint32_t sigma1(uint32_t x) {
+        return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25);
+    }
+
+    constexpr uint32_t gamma0(uint32_t x) {
+        return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3);
+    }
+
+    constexpr uint32_t gamma1(uint32_t x) {
+        return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10);
+    }
+
+    /**
+     * @brief Reference compression of one 64-byte block
+     *
+     * Usable in constant expressions; also the body of the portable runtime
+     * kernel, so the compile-time known-answer tests cover the code that
+     * the scalar fallback actually executes.
+     */
+    constexpr void compress_block(uint32_t* state, const uint8_t* block) {
+        uint32_t w[64] = {};
+
+        // Copy block into first 16 words
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+                   (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+                   (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+                   (static_cast<uint32_t>(block[i * 4 + 3]));
+        }
+
+        // Extend to 64 words
+        for (int i = 16; i < 64; ++i) {
+            w[i] = gamma1(w[i-2]) + w[i-7] + gamma0(w[i-15]) + w[i-16];
+        }
+
+        // Initialize working variables
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], hh = state[7];
+
+        // Compression function
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = hh + sigma1(e) + ch(e, f, g) + K[i] + w[i];
+            uint32_t t2 = sigma0(a) + maj(a, b, c);
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        // Add to hash
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += hh;
+    }
+}
+
+/**
+ * @class SHA256
+ * @brief Streaming SHA-256 hash context
+ *
+ * A context can be copied at any point; the copy carries the midstate and
+ * can be finalized independently of the original.
+ */
+class SHA256 {
+public:
+    static constexpr size_t BLOCK_SIZE = 64;   // 512-bit message blocks
+    static constexpr size_t DIGEST_SIZE = 32;  // 256-bit digest
+
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+    using State = std::array<uint32_t, 8>;
+
+    // Initial hash value H(0)
+    static constexpr State INITIAL_STATE = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    SHA256() { reset(); }
+
+    /**
+     * @brief Reset the context to the SHA-256 initial hash value
+     */
+    void reset();
+
+    /**
+     * @brief Absorb a span of bytes
+     * @param data Pointer to the input bytes
+     * @param len Number of bytes to absorb
+     */
+    void update(const uint8_t* data, size_t len);
+
+    void update(uint8_t byte) { update(&byte, 1); }
+
+    void update(const std::vector<uint8_t>& data) { update(data.data(), data.size()); }
+
+    template <size_t N>
+    void update(const std::array<uint8_t, N>& data) { update(data.data(), N); }
+
+    /**
+     * @brief Apply the final padding and produce the digest
+     * @return 32-byte digest
+     *
+     * The context must be reset before it is reused.
+     */
+    Digest finalize();
+
+    /**
+     * @brief One-shot hash of a contiguous buffer
+     */
+    static Digest hash(const uint8_t* data, size_t len);
+
+    /**
+     * @brief SHA-256 compression function over whole 64-byte blocks
+     * @param state Eight-word chaining value, updated in place
+     * @param blocks Pointer to num_blocks consecutive 64-byte blocks
+     * @param num_blocks Number of blocks to process
+     *
+     * Dispatches to the SHA-NI kernel when the CPU supports it, otherwise to
+     * the portable scalar loop.
+     */
+    static void compress(uint32_t state[8], const uint8_t* blocks, size_t num_blocks);
+
+    /**
+     * @brief Name of the compression kernel selected at startup
+     * @return "SHA-NI" or "scalar"
+     */
+    static std::string kernelName();
+
+    /**
+     * @brief Multi-buffer compression: one block into each of several states
+     * @param states num_lanes independent chaining values, updated in place
+     * @param blocks num_lanes consecutive 64-byte blocks; block i feeds states[i]
+     * @param num_lanes Number of independent messages
+     *
+     * Full groups of eight run through the AVX2 8-lane kernel when available;
+     * the remainder (or everything, without AVX2) goes through compress().
+     */
+    static void compressLanes(State* states, const uint8_t* blocks, size_t num_lanes);
+
+    /**
+     * @brief Preferred batch size for compressLanes()
+     * @return 8 when the AVX2 multi-buffer kernel beats serial compression
+     *         (AVX2 present, SHA-NI absent), otherwise 1
+     */
+    static size_t multiBufferLanes();
+
+    /**
+     * @brief Serialize a chaining value as a big-endian digest
+     */
+    static constexpr void storeDigest(const State& state, uint8_t* out) {
+        for (int i = 0; i < 8; ++i) {
+            out[i * 4] = static_cast<uint8_t>((state[i] >> 24) & 0xFF);
+            out[i * 4 + 1] = static_cast<uint8_t>((state[i] >> 16) & 0xFF);
+            out[i * 4 + 2] = static_cast<uint8_t>((state[i] >> 8) & 0xFF);
+            out[i * 4 + 3] = static_cast<uint8_t>(state[i] & 0xFF);
+        }
+    }
+
+    /**
+     * @brief Compile-time SHA-256 of a fixed-size message
+     * @param message Message bytes
+     * @return 32-byte digest, computable in constant expressions
+     */
+    template <size_t N>
+    static constexpr Digest hashConst(const std::array<uint8_t, N>& message) {
+        constexpr size_t padded_len = (N + 1 + 8 + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        std::array<uint8_t, padded_len> padded = {};
+        for (size_t i = 0; i < N; ++i) {
+            padded[i] = message[i];
+        }
+        padded[N] = 0x80;
+        const uint64_t bit_len = static_cast<uint64_t>(N) * 8;
+        for (int i = 0; i < 8; ++i) {
+            padded[padded_len - 1 - i] = static_cast<uint8_t>((bit_len >> (i * 8)) & 0xFF);
+        }
+
+        State state = INITIAL_STATE;
+        for (size_t offset = 0; offset < padded_len; offset += BLOCK_SIZE) {
+            sha256_detail::compress_block(state.data(), padded.data() + offset);
+        }
+
+        Digest result = {};
+        storeDigest(state, result.data());
+        return result;
+    }
+
+private:
+    State h;
+    std::array<uint8_t, BLOCK_SIZE> buffer;
+    size_t buffer_len;
+    uint64_t total_len;  // bytes absorbed so far
+};
+
+/**
+ * @class HMAC_SHA256
+ * @brief Streaming HMAC-SHA256 context for keys of at most one block
+ */
+class HMAC_SHA256 {
+public:
+    /**
+     * @brief Key the context
+     * @param key Pointer to the key bytes
+     * @param key_len Key length in bytes (at most SHA256::BLOCK_SIZE)
+     */
+    HMAC_SHA256(const uint8_t* key, size_t key_len);
+
+    template <size_t N>
+    explicit HMAC_SHA256(const std::array<uint8_t, N>& key) : HMAC_SHA256(key.data(), N) {}
+
+    template <typename... Args>
+    void update(Args&&... args) { inner.update(std::forward<Args>(args)...); }
+
+    /**
+     * @brief Produce the MAC over everything absorbed since keying
+     */
+    SHA256::Digest finalize();
+
+    /**
+     * @brief Compile-time HMAC-SHA256 of a fixed-size message
+     */
+    template <size_t KeyLen, size_t N>
+    static constexpr SHA256::Digest macConst(const std::array<uint8_t, KeyLen>& key,
+                                             const std::array<uint8_t, N>& message) {
+        static_assert(KeyLen <= SHA256::BLOCK_SIZE, "HMAC_SHA256: key longer than one block");
+
+        std::array<uint8_t, SHA256::BLOCK_SIZE + N> inner_data = {};
+        std::array<uint8_t, SHA256::BLOCK_SIZE + SHA256::DIGEST_SIZE> outer_data = {};
+        for (size_t i = 0; i < SHA256::BLOCK_SIZE; ++i) {
+            uint8_t k = (i < KeyLen) ? key[i] : 0x00;
+            inner_data[i] = k ^ 0x36;
+            outer_data[i] = k ^ 0x5c;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            inner_data[SHA256::BLOCK_SIZE + i] = message[i];
+        }
+
+        auto inner_hash = SHA256::hashConst(inner_data);
+        for (size_t i = 0; i < SHA256::DIGEST_SIZE; ++i) {
+            outer_data[SHA256::BLOCK_SIZE + i] = inner_hash[i];
+        }
+        return SHA256::hashConst(outer_data);
+    }
+
+private:
+    SHA256 inner;  // H(K ^ ipad || ...)
+    SHA256 outer;  // H(K ^ opad || ...)
+};
+
+#endif // SHA256_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file shared_ctr_drbg.hpp
+ * @brief AES-256 CTR_DRBG that many threads share without a lock
+ *
+ * Counter mode is random access, so threads can share one key as long as
+ * they never encrypt the same counter value. SharedCTR_DRBG hands out
+ * disjoint counter ranges with a single atomic fetch_add and lets each
+ * thread encrypt its range on its own. Instead of an update after every
+ * request, the key rotates once per epoch: after EPOCH_BLOCKS blocks, or
+ * when reseed() is called.
+ */
+
+#ifndef SHARED_CTR_DRBG_HPP
+#define SHARED_CTR_DRBG_HPP
+
+#include "drbg.hpp"
+#include "aes256.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class SharedCTR_DRBG
+ * @brief Thread-safe AES-256 CTR_DRBG with lock-free counter reservation
+ *
+ * The reservation word holds the epoch in its high 32 bits and the next
+ * free block of that epoch in its low 32 bits. A request adds its block
+ * count to the word, reads that epoch's key and base counter from one of
+ * two seqlock-protected slots, and encrypts base + offset onwards. When a
+ * reservation runs past the epoch's budget, one thread derives the next
+ * key and counter with the SP 800-90A update, taken from counter values
+ * just past the budget that are never output. It fills the other slot,
+ * switches the word to the new epoch and wipes the old slot. Requests that
+ * raced with the switch see a retired slot or an exhausted budget and
+ * reserve again. Rotation is the only step that takes a lock.
+ *
+ * Instantiation matches AES_CTR_DRBG, so the first request returns the
+ * same output. After that the two differ: within an epoch there is no
+ * per-request update, so a compromise of the current key exposes output
+ * of the current epoch (at most EPOCH_BLOCKS blocks), not earlier ones.
+ */
+class SharedCTR_DRBG : public DRBG {
+public:
+    static constexpr size_t BLOCK_SIZE = AES256::BLOCK_SIZE;
+    // Key lifetime: 1 MiB of output
+    static constexpr uint64_t EPOCH_BLOCKS = uint64_t(1) << 16;
+    // SP 800-90A limit of 2^19 bits; larger requests take several reservations
+    static constexpr size_t MAX_REQUEST_BYTES = size_t(1) << 16;
+
+    /**
+     * @param seed entropy_input || nonce || personalization_string
+     */
+    explicit SharedCTR_DRBG(const std::vector<uint8_t>& seed);
+    ~SharedCTR_DRBG() override;
+
+    SharedCTR_DRBG(const SharedCTR_DRBG&) = delete;
+    SharedCTR_DRBG& operator=(const SharedCTR_DRBG&) = delete;
+
+    void generateInto(uint8_t* out, size_t num_bits) override;
+
+    /**
+     * @brief Start a new epoch whose key and counter absorb the seed
+     *
+     * Requests already holding a reservation in the old epoch may still
+     * finish with the old key.
+     */
+    void reseed(const std::vector<uint8_t>& seed) override;
+
+    std::string getName() const override { return "AES-CTR-DRBG/shared"; }
+    size_t getStateSize() const override { return sizeof(EpochSlot) * 2 + sizeof(reservation); }
+
+    /**
+     * @brief Current epoch (1 after instantiation, +1 per rotation or reseed)
+     */
+    uint32_t currentEpoch() const {
+        return static_cast<uint32_t>(reservation.load(std::memory_order_acquire) >> OFFSET_BITS);
+    }
+
+private:
+    static constexpr unsigned OFFSET_BITS = 32;
+    static constexpr uint64_t OFFSET_MASK = (uint64_t(1) << OFFSET_BITS) - 1;
+    static constexpr uint64_t MAX_REQUEST_BLOCKS = MAX_REQUEST_BYTES / BLOCK_SIZE;
+
+    // The offset must never carry into the epoch bits. A reservation is only
+    // added while the offset is within the budget, and a thread that finds
+    // the budget spent rotates before it reserves again, so at most one
+    // reservation per thread can land past EPOCH_BLOCKS. The offset
+    // restarts at 0 each epoch, however long the generator runs. That makes
+    // the limit MAX_THREADS concurrent callers.
+    static constexpr uint64_t MAX_THREADS = uint64_t(1) << 19;
+    static_assert(EPOCH_BLOCKS + MAX_THREADS * MAX_REQUEST_BLOCKS <= OFFSET_MASK,
+                  "reservations past the epoch budget could carry into the epoch bits");
+    static constexpr size_t KEY_WORDS = sizeof(AES256::RoundKeys) / 8;
+
+    using SeedMaterial = std::array<uint8_t, AES256::KEY_SIZE + BLOCK_SIZE>;
+
+    // One epoch's round keys and base counter, readable by any thread
+    struct alignas(64) EpochSlot {
+        // 2 * epoch + 2 while valid; odd while being written or once retired
+        std::atomic<uint64_t> sequence{1};
+        std::atomic<uint64_t> round_keys[KEY_WORDS];
+        std::atomic<uint64_t> base[2];
+    };
+
+    struct Snapshot {
+        AES256::RoundKeys round_keys;
+        AES256::Block base;
+    };
+
+    alignas(64) std::atomic<uint64_t> reservation;
+    EpochSlot slots[2];
+
+    // Rotation state, guarded by rotate_lock: the current epoch's key and base
+    std::mutex rotate_lock;
+    AES256::RoundKeys current_keys;
+    AES256::Block current_base;
+
+    // Copy epoch's slot; false if the slot no longer (or does not yet) hold it
+    bool read_slot(uint32_t epoch, Snapshot& out) const;
+    void write_slot(uint32_t epoch);
+    void retire_slot(uint32_t epoch);
+
+    // SP 800-90A update from counter, then publish the result as epoch + 1
+    void advance_epoch(uint32_t epoch, AES256::Block counter, const SeedMaterial& provided);
+    // Rotate away from epoch unless another thread already has
+    void rotate(uint32_t epoch);
+};
+
+#endif // SHARED_CTR_DRBG_HPP
@@ -0,0 +1,42 @@
+/**
+ * @file spn_bitslice.hpp
+ * @brief Bit-sliced AVX2 backend for the CTR_DRBG SPN cipher
+ *
+ * Encrypts 32 counter blocks at a time with every state bit of a byte
+ * position held in one bit of a 32-bit lane. The S-box is evaluated as a
+ * boolean circuit and the permutation/MixColumns are register shuffles, so
+ * the kernel performs no data-dependent table lookups.
+ */
+
+#ifndef SPN_BITSLICE_HPP
+#define SPN_BITSLICE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace spn_bitslice {
+
+constexpr size_t BATCH_BLOCKS = 32;  // Blocks encrypted per kernel invocation
+constexpr int MAX_ROUNDS = 16;       // Upper bound on the rounds argument
+
+/**
+ * @brief Whether the running CPU can execute the AVX2 kernel
+ */
+bool available();
+
+/**
+ * @brief Counter-mode keystream with the bit-sliced SPN
+ * @param round_keys rounds * 4 little-endian round-key words (as in CTR_DRBG)
+ * @param rounds Number of SPN rounds; MixColumns is skipped in the last one
+ * @param counter 16-byte big-endian counter, advanced by num_blocks
+ * @param out Output buffer for num_blocks * 16 bytes
+ * @param num_blocks Number of blocks; block k encrypts counter + k (k >= 1)
+ *
+ * Must only be called when available() returns true.
+ */
+void keystream(const uint32_t* round_keys, int rounds, uint8_t counter[16],
+               uint8_t* out, size_t num_blocks);
+
+} // namespace spn_bitslice
+
+#endif // SPN_BITSLICE_HPP
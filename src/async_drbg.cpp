@@ -0,0 +1,154 @@
+/**
+ * @file async_drbg.cpp
+ * @brief Worker pool, event loop and chunked asynchronous generation
+ */
+
+#include "async_drbg.hpp"
+#include <algorithm>
+
+// ============================================================================
+// WorkerPool
+// ============================================================================
+
+WorkerPool::WorkerPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+void WorkerPool::work() {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        ready.wait(guard, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;  // Stopping with nothing left to run
+        }
+        std::function<void()> task = std::move(queue.front());
+        queue.pop_front();
+        guard.unlock();
+        task();
+        guard.lock();
+    }
+}
+
+// ============================================================================
+// EventLoop
+// ============================================================================
+
+void EventLoop::post(std::function<void()> task) {
+    // Notify under the lock: the posted task may be the one that lets the
+    // loop's owner return and destroy the loop
+    std::lock_guard<std::mutex> guard(lock);
+    queue.push_back(std::move(task));
+    ready.notify_one();
+}
+
+size_t EventLoop::poll() {
+    std::vector<std::function<void()>> batch;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        batch.swap(queue);
+    }
+    // Tasks posted while these run wait for the next poll
+    for (auto& task : batch) {
+        task();
+    }
+    return batch.size();
+}
+
+size_t EventLoop::runUntil(std::chrono::steady_clock::time_point deadline) {
+    size_t ran = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if (!ready.wait_until(guard, deadline, [this] { return !queue.empty(); })) {
+                return ran;
+            }
+        }
+        ran += poll();
+        // Tasks that keep posting more must not hold off the deadline
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return ran;
+        }
+    }
+}
+
+// ============================================================================
+// AsyncDRBG
+// ============================================================================
+
+void AsyncDRBG::generateInto(uint8_t* out, size_t num_bits) {
+    std::lock_guard<std::mutex> guard(lock);
+    drbg.generateInto(out, num_bits);
+}
+
+void AsyncDRBG::reseed(const std::vector<uint8_t>& seed) {
+    std::lock_guard<std::mutex> guard(lock);
+    drbg.reseed(seed);
+}
+
+bool AsyncDRBG::GenerateOperation::await_ready() {
+    if (remaining_bits > INLINE_BYTES * 8) {
+        return false;
+    }
+    try {
+        owner.generateInto(out, remaining_bits);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    return true;
+}
+
+void AsyncDRBG::GenerateOperation::await_suspend(std::coroutine_handle<> handle) {
+    caller = handle;
+    owner.pool.post([this] { run_chunk(); });
+}
+
+void AsyncDRBG::GenerateOperation::await_resume() {
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void AsyncDRBG::GenerateOperation::run_chunk() {
+    size_t chunk_bits = std::min(remaining_bits, CHUNK_BYTES * 8);
+    try {
+        owner.generateInto(out, chunk_bits);
+        out += chunk_bits / 8;
+        remaining_bits -= chunk_bits;
+    } catch (...) {
+        error = std::current_exception();
+        remaining_bits = 0;
+    }
+
+    if (remaining_bits > 0) {
+        // Requeue rather than loop, so other requests' chunks get a turn
+        owner.pool.post([this] { run_chunk(); });
+    } else if (resume_on != nullptr) {
+        resume_on->post([handle = caller] { handle.resume(); });
+    } else {
+        caller.resume();
+    }
+}
@@ -4,9 +4,49 @@
  */
 
 #include "benchmark.hpp"
+#include "distributions.hpp"
+#include "sampling.hpp"
+#include "drbg_prefetcher.hpp"
+#include "shared_ctr_drbg.hpp"
 #include <iomanip>
 #include <sstream>
 #include <cmath>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <tuple>
+
+namespace {
+    // Issue the requests one after another, resuming on the loop each time
+    AsyncTask issue_requests(AsyncDRBG& rng, EventLoop& loop, uint8_t* out, size_t num_bits,
+                             size_t count, bool& done) {
+        for (size_t i = 0; i < count; ++i) {
+            co_await rng.asyncGenerate(out, num_bits, &loop);
+        }
+        done = true;
+    }
+
+    /**
+     * Run the loop with a periodic tick until done (set by a loop task) and
+     * report elapsed milliseconds and the p99 and max tick lateness in us
+     */
+    std::tuple<double, double, double> drive_loop(EventLoop& loop, const bool& done) {
+        constexpr auto TICK = std::chrono::microseconds(500);
+        std::vector<double> lateness;
+        auto start = std::chrono::steady_clock::now();
+        auto next_tick = start + TICK;
+        while (!done) {
+            loop.runUntil(next_tick);
+            auto now = std::chrono::steady_clock::now();
+            lateness.push_back(std::chrono::duration<double, std::micro>(now - next_tick).count());
+            next_tick = now + TICK;
+        }
+        double elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        std::sort(lateness.begin(), lateness.end());
+        return {elapsed_ms, lateness[lateness.size() * 99 / 100], lateness.back()};
+    }
+}
 
 BenchmarkResult Benchmark::run(DRBG* drbg, size_t num_bits) {
     BenchmarkResult result;
@@ -23,6 +63,12 @@ BenchmarkResult Benchmark::run(DRBG* drbg, size_t num_bits) {
     
     result.output_size = data.size();
     
+    // Same request into a buffer allocated outside the timed region
+    std::vector<uint8_t> buffer(data.size());
+    timer.start();
+    drbg->generateInto(buffer.data(), num_bits);
+    result.generation_into_time_us = timer.elapsedMicroseconds();
+    
     // Count bit distribution
     auto [zeros, ones] = countBits(data, num_bits);
     result.count_zeros = zeros;
@@ -36,6 +82,310 @@ BenchmarkResult Benchmark::run(DRBG* drbg, size_t num_bits) {
     result.bits_per_microsecond = (result.generation_time_us > 0) 
         ? num_bits / result.generation_time_us 
         : 0;
+    result.bits_per_microsecond_into = (result.generation_into_time_us > 0)
+        ? num_bits / result.generation_into_time_us
+        : 0;
+    
+    return result;
+}
+
+DrawResult Benchmark::runDraws(DRBG& drbg, size_t buffer_bytes, size_t num_draws) {
+    DrawResult result;
+    result.drbg_name = drbg.getName();
+    
+    // Every draw feeds the sink so none can be optimized away
+    volatile uint64_t sink = 0;
+    Timer timer;
+    
+    if (buffer_bytes == 0) {
+        result.buffer_bytes = 0;
+        uint8_t draw[8];
+        timer.start();
+        for (size_t i = 0; i < num_draws; ++i) {
+            drbg.generateInto(draw, 64);
+            sink = sink ^ draw[0];
+        }
+    } else {
+        DRBGReader reader(drbg, buffer_bytes);
+        result.buffer_bytes = reader.bufferSize();
+        timer.start();
+        for (size_t i = 0; i < num_draws; ++i) {
+            sink = sink ^ reader.nextUint64();
+        }
+    }
+    
+    double elapsed_us = timer.elapsedMicroseconds();
+    result.draws_per_second = (elapsed_us > 0) ? num_draws * 1e6 / elapsed_us : 0;
+    return result;
+}
+
+UniformResult Benchmark::runUniform(DRBG& drbg, uint32_t bound, size_t count) {
+    UniformResult result;
+    result.drbg_name = drbg.getName();
+    result.bound = bound;
+    
+    volatile uint32_t sink = 0;
+    Timer timer;
+    auto rate = [count](double elapsed_us) {
+        return (elapsed_us > 0) ? count / elapsed_us : 0;
+    };
+    
+    {
+        DRBGReader reader(drbg);
+        std::uniform_int_distribution<uint32_t> dist(0, bound - 1);
+        timer.start();
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink ^ dist(reader);
+        }
+        result.std_mvalues_per_second = rate(timer.elapsedMicroseconds());
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        timer.start();
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink ^ Uniform::below(reader, bound);
+        }
+        result.below_mvalues_per_second = rate(timer.elapsedMicroseconds());
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        std::vector<uint32_t> values(count);
+        timer.start();
+        Uniform::fillBelow(reader, bound, values.data(), count);
+        result.fill_mvalues_per_second = rate(timer.elapsedMicroseconds());
+        sink = sink ^ values[count / 2];
+    }
+    
+    return result;
+}
+
+RealResult Benchmark::runReals(DRBG& drbg, size_t count) {
+    RealResult result;
+    result.drbg_name = drbg.getName();
+    
+    volatile double sink = 0;
+    Timer timer;
+    auto rate = [count](double elapsed_us) {
+        return (elapsed_us > 0) ? count / elapsed_us : 0;
+    };
+    std::vector<double> doubles(count);
+    std::vector<float> floats(count);
+    
+    {
+        DRBGReader reader(drbg);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        timer.start();
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink + dist(reader);
+        }
+        result.std_uniform_mvalues_per_second = rate(timer.elapsedMicroseconds());
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        timer.start();
+        Uniform::fillDoubles(reader, doubles.data(), count);
+        result.doubles_mvalues_per_second = rate(timer.elapsedMicroseconds());
+        sink = sink + doubles[count / 2];
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        timer.start();
+        Uniform::fillFloats(reader, floats.data(), count);
+        result.floats_mvalues_per_second = rate(timer.elapsedMicroseconds());
+        sink = sink + floats[count / 2];
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        std::normal_distribution<double> dist(0.0, 1.0);
+        timer.start();
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink + dist(reader);
+        }
+        result.std_normal_mvalues_per_second = rate(timer.elapsedMicroseconds());
+    }
+    
+    {
+        DRBGReader reader(drbg);
+        timer.start();
+        Normal::fill(reader, doubles.data(), count);
+        result.normal_mvalues_per_second = rate(timer.elapsedMicroseconds());
+        sink = sink + doubles[count / 2];
+    }
+    
+    return result;
+}
+
+ShuffleResult Benchmark::runShuffle(DRBG& drbg, size_t num_elements) {
+    constexpr size_t RESERVOIR_SIZE = 1000;
+    ShuffleResult result;
+    result.drbg_name = drbg.getName();
+    result.num_elements = num_elements;
+    
+    Timer timer;
+    auto rate = [num_elements](double elapsed_us) {
+        return (elapsed_us > 0) ? num_elements / elapsed_us : 0;
+    };
+    std::vector<uint32_t> data(num_elements);
+    std::iota(data.begin(), data.end(), 0);
+    
+    {
+        DRBGReader reader(drbg, 64 * 1024);
+        timer.start();
+        std::shuffle(data.begin(), data.end(), reader);
+        result.std_shuffle_melements_per_second = rate(timer.elapsedMicroseconds());
+    }
+    
+    timer.start();
+    Sampling::shuffle(drbg, data.data(), data.size());
+    result.shuffle_melements_per_second = rate(timer.elapsedMicroseconds());
+    
+    std::vector<uint32_t> sample(RESERVOIR_SIZE);
+    timer.start();
+    Sampling::reservoirSample(drbg, data.begin(), data.end(), sample.data(), sample.size());
+    result.reservoir_melements_per_second = rate(timer.elapsedMicroseconds());
+    
+    return result;
+}
+
+SharedCounterResult Benchmark::runSharedCounter(const std::vector<uint8_t>& seed,
+                                                size_t num_threads, size_t total_requests) {
+    constexpr size_t REQUEST_BITS = 256;
+    size_t per_thread = total_requests / num_threads;
+    
+    SharedCounterResult result;
+    result.num_threads = num_threads;
+    auto rate = [&](double elapsed_us) {
+        return (elapsed_us > 0) ? per_thread * num_threads / elapsed_us : 0;
+    };
+    auto time_locked = [&](DRBG& drbg) {
+        std::mutex lock;
+        return rate(timeThreads(num_threads, [&] {
+            uint8_t out[REQUEST_BITS / 8];
+            for (size_t i = 0; i < per_thread; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+                drbg.generateInto(out, REQUEST_BITS);
+            }
+        }));
+    };
+    
+    CTR_DRBG ctr(seed, CTR_DRBG::Cipher::TTable);
+    result.locked_ctr_mrequests_per_second = time_locked(ctr);
+    AES_CTR_DRBG aes(seed);
+    result.locked_aes_mrequests_per_second = time_locked(aes);
+    
+    SharedCTR_DRBG shared(seed);
+    result.shared_mrequests_per_second = rate(timeThreads(num_threads, [&] {
+        uint8_t out[REQUEST_BITS / 8];
+        for (size_t i = 0; i < per_thread; ++i) {
+            shared.generateInto(out, REQUEST_BITS);
+        }
+    }));
+    
+    return result;
+}
+
+ContentionResult Benchmark::timeContention(DRBG& drbg, const std::string& strategy,
+                                           size_t num_threads, size_t num_bits, size_t per_thread) {
+    ContentionResult result;
+    result.strategy = strategy;
+    result.num_threads = num_threads;
+    result.num_bits = num_bits;
+    
+    // Each thread claims its own slice of the latency array
+    std::vector<double> latencies(num_threads * per_thread);
+    std::atomic<size_t> next_thread{0};
+    double elapsed_us = timeThreads(num_threads, [&] {
+        double* mine = latencies.data() + next_thread.fetch_add(1) * per_thread;
+        std::vector<uint8_t> out((num_bits + 7) / 8);
+        for (size_t i = 0; i < per_thread; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            drbg.generateInto(out.data(), num_bits);
+            auto end = std::chrono::steady_clock::now();
+            mine[i] = std::chrono::duration<double, std::micro>(end - start).count();
+        }
+    });
+    
+    size_t total_bytes = latencies.size() * ((num_bits + 7) / 8);
+    result.mbytes_per_second = (elapsed_us > 0) ? total_bytes / elapsed_us : 0;
+    std::sort(latencies.begin(), latencies.end());
+    result.p50_us = latencies[latencies.size() / 2];
+    result.p99_us = latencies[latencies.size() * 99 / 100];
+    return result;
+}
+
+PrefetchLatencyResult Benchmark::runPrefetchLatency(DRBG& drbg, size_t num_bits,
+                                                    size_t num_requests) {
+    constexpr size_t BURST = 32;
+    constexpr auto IDLE = std::chrono::microseconds(200);
+    PrefetchLatencyResult result;
+    result.drbg_name = drbg.getName();
+    result.num_bits = num_bits;
+    
+    std::vector<uint8_t> out((num_bits + 7) / 8);
+    std::vector<double> latencies(num_requests);
+    auto measure = [&](DRBG& target) {
+        for (size_t i = 0; i < num_requests; ++i) {
+            if (i % BURST == 0) {
+                std::this_thread::sleep_for(IDLE);
+            }
+            auto start = std::chrono::steady_clock::now();
+            target.generateInto(out.data(), num_bits);
+            auto end = std::chrono::steady_clock::now();
+            latencies[i] = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+        std::sort(latencies.begin(), latencies.end());
+        return std::make_pair(latencies[num_requests / 2], latencies[num_requests * 99 / 100]);
+    };
+    
+    std::tie(result.direct_p50_ns, result.direct_p99_ns) = measure(drbg);
+    
+    DRBGPrefetcher prefetcher(drbg);
+    // Let the producer fill the ring before the first burst
+    while (prefetcher.available() < prefetcher.capacitySlots()) {
+        std::this_thread::yield();
+    }
+    std::tie(result.prefetch_p50_ns, result.prefetch_p99_ns) = measure(prefetcher);
+    result.miss_percent = 100.0 * prefetcher.misses() / num_requests;
+    
+    return result;
+}
+
+LoopResponsivenessResult Benchmark::runLoopResponsiveness(DRBG& drbg, WorkerPool& pool,
+                                                         size_t num_bits, size_t num_requests) {
+    LoopResponsivenessResult result;
+    result.drbg_name = drbg.getName();
+    result.num_bits = num_bits;
+    std::vector<uint8_t> out((num_bits + 7) / 8);
+    
+    {
+        EventLoop loop;
+        bool done = false;
+        size_t issued = 0;
+        std::function<void()> request = [&] {
+            drbg.generateInto(out.data(), num_bits);
+            if (++issued == num_requests) {
+                done = true;
+            } else {
+                loop.post(request);
+            }
+        };
+        loop.post(request);
+        std::tie(result.blocking_ms, result.blocking_p99_us, result.blocking_max_us) =
+            drive_loop(loop, done);
+    }
+    
+    {
+        EventLoop loop;
+        AsyncDRBG rng(drbg, pool);
+        bool done = false;
+        loop.post([&] { issue_requests(rng, loop, out.data(), num_bits, num_requests, done); });
+        std::tie(result.async_ms, result.async_p99_us, result.async_max_us) = drive_loop(loop, done);
+    }
     
     return result;
 }
@@ -65,7 +415,8 @@ void Benchmark::exportToCSV(const std::vector<BenchmarkResult>& results, const s
     
     // Header
     file << "DRBG,NumBits,GenerationTimeUs,StateSize,OutputSize,"
-         << "Zeros,Ones,Ratio,Bias,BitsPerMicrosecond\n";
+         << "Zeros,Ones,Ratio,Bias,BitsPerMicrosecond,"
+         << "GenerateIntoTimeUs,BitsPerMicrosecondInto\n";
     
     // Data
     for (const auto& r : results) {
@@ -78,7 +429,9 @@ void Benchmark::exportToCSV(const std::vector<BenchmarkResult>& results, const s
              << r.count_ones << ","
              << std::setprecision(6) << r.ratio << ","
              << std::setprecision(8) << r.bias << ","
-             << std::setprecision(2) << r.bits_per_microsecond << "\n";
+             << std::setprecision(2) << r.bits_per_microsecond << ","
+             << r.generation_into_time_us << ","
+             << r.bits_per_microsecond_into << "\n";
     }
     
     file.close();
@@ -102,7 +455,7 @@ df = pd.read_csv(')" << csv_file << R"(')
 
 # Get unique DRBG names
 drbgs = df['DRBG'].unique()
-colors = ['#2ecc71', '#3498db']
+colors = ['#2ecc71', '#27ae60', '#16a085', '#1abc9c', '#3498db', '#e67e22', '#9b59b6', '#e74c3c']
 
 # Create figure with subplots
 fig, axes = plt.subplots(2, 2, figsize=(14, 10))
@@ -323,6 +676,9 @@ void Benchmark::generateHTMLVisualization(const std::vector<BenchmarkResult>& re
     <script>
         const colors = {
             'CTR-DRBG': '#2ecc71',
+            'CTR-DRBG-T': '#27ae60',
+            'CTR-DRBG-BS': '#16a085',
+            'AES-CTR-DRBG': '#1abc9c',
             'Hash-DRBG': '#3498db'
         };
 
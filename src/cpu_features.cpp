@@ -0,0 +1,79 @@
+/**
+ * @file cpu_features.cpp
+ * @brief cpuid-based CPU feature detection
+ */
+
+#include "cpu_features.hpp"
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t read_xcr0() {
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+    }
+
+    // Largest data or unified cache in the deterministic cache parameters
+    // leaf: 4 on Intel, 0x8000001D on AMD
+    size_t detect_llc_bytes() {
+        size_t largest = 0;
+        for (unsigned int leaf : {0x4u, 0x8000001Du}) {
+            if (__get_cpuid_max(leaf & 0x80000000u, nullptr) < leaf) {
+                continue;
+            }
+            for (unsigned int sub = 0; sub < 16; ++sub) {
+                unsigned int eax, ebx, ecx, edx;
+                __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+                unsigned int type = eax & 0x1f;
+                if (type == 0) break;      // No more caches
+                if (type == 2) continue;   // Instruction cache
+                size_t ways = (ebx >> 22) + 1;
+                size_t partitions = ((ebx >> 12) & 0x3ff) + 1;
+                size_t line = (ebx & 0xfff) + 1;
+                size_t sets = static_cast<size_t>(ecx) + 1;
+                largest = std::max(largest, ways * partitions * line * sets);
+            }
+            if (largest > 0) break;
+        }
+        return largest;
+    }
+#endif
+
+    CpuFeatures detect() {
+        CpuFeatures f;
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return f;
+        }
+        f.ssse3 = (ecx & bit_SSSE3) != 0;
+        f.sse41 = (ecx & bit_SSE4_1) != 0;
+        f.aesni = (ecx & bit_AES) != 0;
+
+        // YMM/ZMM registers are only usable if the OS saves them (XCR0)
+        bool osxsave = (ecx & bit_OSXSAVE) != 0;
+        uint64_t xcr0 = osxsave ? read_xcr0() : 0;
+        bool ymm_enabled = (xcr0 & 0x6) == 0x6;
+        bool zmm_enabled = (xcr0 & 0xe6) == 0xe6;
+
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            f.sha = (ebx & bit_SHA) != 0;
+            f.avx2 = ymm_enabled && (ebx & bit_AVX2) != 0;
+            f.avx512f = zmm_enabled && (ebx & bit_AVX512F) != 0;
+        }
+        f.llc_bytes = detect_llc_bytes();
+#endif
+        return f;
+    }
+}
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = detect();
+    return features;
+}
@@ -0,0 +1,435 @@
+/**
+ * @file distributions.cpp
+ * @brief Bounded-integer, unit-interval and normal sampling with bulk kernels
+ */
+
+#include "distributions.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DISTRIBUTIONS_HAVE_X86_KERNELS 1
+#endif
+
+// ============================================================================
+// Bulk Mapping Kernels
+// ============================================================================
+
+namespace {
+    // Replace data[i] by the high half of data[i] * n, stopping at the first
+    // block holding a word whose low half is below threshold (a rejection).
+    // Returns the index where mapping stopped; the caller finishes that block.
+    using BoundFn = size_t (*)(uint32_t*, size_t, uint32_t, uint32_t);
+
+    constexpr size_t BOUND_BLOCK = 8;
+
+    // A 32-bit word is rejected up to n / 2^32 of the time, i.e. nearly half
+    // the time just above 2^31. Larger bounds draw 64-bit words instead.
+    constexpr uint32_t NARROW_BOUND_MAX = 1u << 26;
+    constexpr size_t WIDE_CHUNK = 256;
+
+    // Unit interval from the mantissa: the top bits of a word under the
+    // exponent of 1.0 give a value in [1, 2); subtracting 1 maps it to [0, 1)
+    inline double unit_double(uint64_t word) {
+        uint64_t bits = (word >> 12) | 0x3FF0000000000000ull;
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d - 1.0;
+    }
+
+    inline float unit_float(uint32_t word) {
+        uint32_t bits = (word >> 9) | 0x3F800000u;
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f - 1.0f;
+    }
+
+    /**
+     * Ziggurat for the standard normal (Marsaglia & Tsang, 2000): 128 layers
+     * of equal area V. Layer i spans [0, x[i]) between heights f[i] and
+     * f[i + 1]; layer 0 is the base strip, whose virtual width V / f(R) folds
+     * in the tail beyond R. A draw picks a layer and a point in it, and is
+     * accepted outright when the point lies under the next layer's edge.
+     */
+    constexpr size_t ZIGGURAT_LAYERS = 128;
+    constexpr double ZIGGURAT_R = 3.442619855899;
+    constexpr double ZIGGURAT_V = 9.91256303526217e-3;
+
+    struct ZigguratTables {
+        double x[ZIGGURAT_LAYERS + 1];
+        double f[ZIGGURAT_LAYERS + 1];  // exp(-x^2 / 2)
+    };
+
+    ZigguratTables build_ziggurat() {
+        auto density = [](double x) { return std::exp(-0.5 * x * x); };
+        ZigguratTables t;
+        t.x[0] = ZIGGURAT_V / density(ZIGGURAT_R);
+        t.x[1] = ZIGGURAT_R;
+        for (size_t i = 2; i < ZIGGURAT_LAYERS; ++i) {
+            t.x[i] = std::sqrt(-2.0 * std::log(ZIGGURAT_V / t.x[i - 1] + density(t.x[i - 1])));
+        }
+        t.x[ZIGGURAT_LAYERS] = 0.0;
+        for (size_t i = 0; i <= ZIGGURAT_LAYERS; ++i) {
+            t.f[i] = density(t.x[i]);
+        }
+        return t;
+    }
+
+    const ZigguratTables& ziggurat() {
+        static const ZigguratTables tables = build_ziggurat();
+        return tables;
+    }
+
+    // Word layout for one ziggurat draw: layer in bits 0-6, sign in bit 7,
+    // position within the layer from the mantissa bits 12-63
+    constexpr uint64_t LAYER_MASK = ZIGGURAT_LAYERS - 1;
+    constexpr int SIGN_BIT = 7;
+    constexpr size_t NORMAL_BLOCK = 4;
+
+    /**
+     * Complete one normal draw that starts from word, drawing from rng when
+     * the point falls in a wedge or the tail. Uniforms for log() come from
+     * 1 - unit_double(), which is never 0.
+     */
+    double normal_from(DRBGReader& rng, uint64_t word) {
+        const ZigguratTables& z = ziggurat();
+        for (;;) {
+            size_t layer = word & LAYER_MASK;
+            bool negative = (word >> SIGN_BIT) & 1;
+            double x = unit_double(word) * z.x[layer];
+            if (x < z.x[layer + 1]) {
+                return negative ? -x : x;
+            }
+            if (layer == 0) {
+                // Tail beyond R (Marsaglia, 1964)
+                double a;
+                double b;
+                do {
+                    a = -std::log(1.0 - unit_double(rng.nextUint64())) / ZIGGURAT_R;
+                    b = -std::log(1.0 - unit_double(rng.nextUint64()));
+                } while (b + b < a * a);
+                x = ZIGGURAT_R + a;
+                return negative ? -x : x;
+            }
+            // Wedge between the layer's rectangle and the curve
+            double y = z.f[layer] + unit_double(rng.nextUint64()) * (z.f[layer + 1] - z.f[layer]);
+            if (y < std::exp(-0.5 * x * x)) {
+                return negative ? -x : x;
+            }
+            word = rng.nextUint64();
+        }
+    }
+
+    // In-place conversions of raw words already stored in the output array
+    using UnitDoublesFn = void (*)(double*, size_t);
+    using UnitFloatsFn = void (*)(float*, size_t);
+    // Ziggurat fast path in place; same stopping contract as BoundFn
+    using NormalFn = size_t (*)(double*, size_t, const ZigguratTables&);
+
+    size_t bound_scalar(uint32_t* data, size_t count, uint32_t n, uint32_t threshold) {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t m = static_cast<uint64_t>(data[i]) * n;
+            if (static_cast<uint32_t>(m) < threshold) {
+                return i;
+            }
+            data[i] = static_cast<uint32_t>(m >> 32);
+        }
+        return count;
+    }
+
+    void unit_doubles_scalar(double* data, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t word;
+            std::memcpy(&word, &data[i], sizeof(word));
+            data[i] = unit_double(word);
+        }
+    }
+
+    void unit_floats_scalar(float* data, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t word;
+            std::memcpy(&word, &data[i], sizeof(word));
+            data[i] = unit_float(word);
+        }
+    }
+
+    size_t normal_scalar(double* data, size_t count, const ZigguratTables& z) {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t word;
+            std::memcpy(&word, &data[i], sizeof(word));
+            size_t layer = word & LAYER_MASK;
+            double x = unit_double(word) * z.x[layer];
+            if (!(x < z.x[layer + 1])) {
+                return i;
+            }
+            data[i] = ((word >> SIGN_BIT) & 1) ? -x : x;
+        }
+        return count;
+    }
+
+#ifdef DISTRIBUTIONS_HAVE_X86_KERNELS
+    /**
+     * AVX2 kernel. vpmuludq multiplies the even 32-bit lanes into 64-bit
+     * products, so even and odd lanes go through it separately and the
+     * halves are blended back together. AVX2 has no unsigned compare; both
+     * sides are biased by 2^31 and compared signed.
+     */
+    __attribute__((target("avx2")))
+    size_t bound_avx2(uint32_t* data, size_t count, uint32_t n, uint32_t threshold) {
+        const __m256i vn = _mm256_set1_epi32(static_cast<int>(n));
+        const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+        const __m256i vt = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(threshold)), bias);
+
+        size_t i = 0;
+        for (; i + BOUND_BLOCK <= count; i += BOUND_BLOCK) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i even = _mm256_mul_epu32(x, vn);
+            __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vn);
+            __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+            __m256i lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+
+            __m256i reject = _mm256_cmpgt_epi32(vt, _mm256_xor_si256(lo, bias));
+            if (!_mm256_testz_si256(reject, reject)) {
+                break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), hi);
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    void unit_doubles_avx2(double* data, size_t count) {
+        const __m256i one_bits = _mm256_set1_epi64x(0x3FF0000000000000ll);
+        const __m256d one = _mm256_set1_pd(1.0);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256d d = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(w, 12), one_bits));
+            _mm256_storeu_pd(data + i, _mm256_sub_pd(d, one));
+        }
+        unit_doubles_scalar(data + i, count - i);
+    }
+
+    __attribute__((target("avx2")))
+    void unit_floats_avx2(float* data, size_t count) {
+        const __m256i one_bits = _mm256_set1_epi32(0x3F800000);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256 f = _mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(w, 9), one_bits));
+            _mm256_storeu_ps(data + i, _mm256_sub_ps(f, one));
+        }
+        unit_floats_scalar(data + i, count - i);
+    }
+
+    /**
+     * Ziggurat fast path, four draws at a time: the layer edges x[i] and
+     * x[i + 1] are gathered per lane, and the sign bit is moved from bit 7
+     * to bit 63 and XORed into the result.
+     */
+    __attribute__((target("avx2")))
+    size_t normal_avx2(double* data, size_t count, const ZigguratTables& z) {
+        const __m256i layer_mask = _mm256_set1_epi64x(LAYER_MASK);
+        const __m256i sign_mask = _mm256_set1_epi64x(static_cast<long long>(1ull << 63));
+        const __m256i one_bits = _mm256_set1_epi64x(0x3FF0000000000000ll);
+        const __m256d one = _mm256_set1_pd(1.0);
+
+        size_t i = 0;
+        for (; i + NORMAL_BLOCK <= count; i += NORMAL_BLOCK) {
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i layer = _mm256_and_si256(w, layer_mask);
+            __m256d edge = _mm256_i64gather_pd(z.x, layer, 8);
+            __m256d next_edge = _mm256_i64gather_pd(z.x + 1, layer, 8);
+            __m256d u = _mm256_sub_pd(
+                _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(w, 12), one_bits)), one);
+            __m256d x = _mm256_mul_pd(u, edge);
+
+            if (_mm256_movemask_pd(_mm256_cmp_pd(x, next_edge, _CMP_LT_OQ)) != 0xF) {
+                break;
+            }
+            __m256i sign = _mm256_and_si256(_mm256_slli_epi64(w, 63 - SIGN_BIT), sign_mask);
+            _mm256_storeu_pd(data + i, _mm256_xor_pd(x, _mm256_castsi256_pd(sign)));
+        }
+        return i;
+    }
+#endif
+
+    struct Kernels {
+        BoundFn bound;
+        UnitDoublesFn unit_doubles;
+        UnitFloatsFn unit_floats;
+        NormalFn normal;
+        const char* name;
+    };
+
+    Kernels select_kernels() {
+#ifdef DISTRIBUTIONS_HAVE_X86_KERNELS
+        if (CpuFeatures::get().avx2) {
+            return {bound_avx2, unit_doubles_avx2, unit_floats_avx2, normal_avx2, "AVX2"};
+        }
+#endif
+        return {bound_scalar, unit_doubles_scalar, unit_floats_scalar, normal_scalar, "scalar"};
+    }
+
+    // Chosen once, on first use, from the cpuid feature bits
+    const Kernels& active_kernels() {
+        static const Kernels kernels = select_kernels();
+        return kernels;
+    }
+
+    // Map one word, redrawing while it falls in the rejected zone
+    uint32_t bound_one(DRBGReader& rng, uint32_t x, uint32_t n, uint32_t threshold) {
+        uint64_t m = static_cast<uint64_t>(x) * n;
+        while (static_cast<uint32_t>(m) < threshold) {
+            m = static_cast<uint64_t>(rng.nextUint32()) * n;
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    // bound_one for a 64-bit word; threshold is 2^64 mod n
+    uint32_t bound_one_wide(DRBGReader& rng, uint64_t x, uint32_t n, uint64_t threshold) {
+        unsigned __int128 m = static_cast<unsigned __int128>(x) * n;
+        while (static_cast<uint64_t>(m) < threshold) {
+            m = static_cast<unsigned __int128>(rng.nextUint64()) * n;
+        }
+        return static_cast<uint32_t>(m >> 64);
+    }
+}
+
+// ============================================================================
+// Uniform Implementation
+// ============================================================================
+
+uint32_t Uniform::below(DRBGReader& rng, uint32_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("Uniform::below: empty range");
+    }
+    if (n > NARROW_BOUND_MAX) {
+        return static_cast<uint32_t>(below64(rng, n));
+    }
+    uint64_t m = static_cast<uint64_t>(rng.nextUint32()) * n;
+    if (static_cast<uint32_t>(m) < n) {
+        // 2^32 mod n: the low halves below it are the surplus that biases
+        uint32_t threshold = (0u - n) % n;
+        while (static_cast<uint32_t>(m) < threshold) {
+            m = static_cast<uint64_t>(rng.nextUint32()) * n;
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+uint64_t Uniform::below64(DRBGReader& rng, uint64_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("Uniform::below64: empty range");
+    }
+    unsigned __int128 m = static_cast<unsigned __int128>(rng.nextUint64()) * n;
+    if (static_cast<uint64_t>(m) < n) {
+        uint64_t threshold = (0 - n) % n;
+        while (static_cast<uint64_t>(m) < threshold) {
+            m = static_cast<unsigned __int128>(rng.nextUint64()) * n;
+        }
+    }
+    return static_cast<uint64_t>(m >> 64);
+}
+
+int64_t Uniform::range(DRBGReader& rng, int64_t lo, int64_t hi) {
+    if (lo > hi) {
+        throw std::invalid_argument("Uniform::range: lo > hi");
+    }
+    // Width minus one, computed without signed overflow
+    uint64_t span = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+    uint64_t offset = (span == ~uint64_t{0}) ? rng.nextUint64() : below64(rng, span + 1);
+    return static_cast<int64_t>(static_cast<uint64_t>(lo) + offset);
+}
+
+void Uniform::fillBelow(DRBGReader& rng, uint32_t n, uint32_t* out, size_t count) {
+    if (n == 0) {
+        throw std::invalid_argument("Uniform::fillBelow: empty range");
+    }
+    if (n > NARROW_BOUND_MAX) {
+        // 64-bit words, a chunk at a time through a stack buffer
+        uint64_t threshold = (0 - static_cast<uint64_t>(n)) % n;
+        uint64_t words[WIDE_CHUNK];
+        for (size_t i = 0; i < count; i += WIDE_CHUNK) {
+            size_t chunk = std::min(count - i, WIDE_CHUNK);
+            rng.readBytes(reinterpret_cast<uint8_t*>(words), chunk * sizeof(uint64_t));
+            for (size_t j = 0; j < chunk; ++j) {
+                out[i + j] = bound_one_wide(rng, words[j], n, threshold);
+            }
+        }
+        return;
+    }
+
+    rng.readBytes(reinterpret_cast<uint8_t*>(out), count * sizeof(uint32_t));
+
+    uint32_t threshold = (0u - n) % n;
+    BoundFn kernel = active_kernels().bound;
+    size_t i = 0;
+    while (i < count) {
+        i += kernel(out + i, count - i, n, threshold);
+        // The kernel stopped at a rejection or the tail: finish this block
+        // one word at a time, in index order so every kernel agrees
+        size_t end = std::min(count, i + BOUND_BLOCK);
+        for (; i < end; ++i) {
+            out[i] = bound_one(rng, out[i], n, threshold);
+        }
+    }
+}
+
+double Uniform::unitDouble(DRBGReader& rng) {
+    return unit_double(rng.nextUint64());
+}
+
+void Uniform::fillDoubles(DRBGReader& rng, double* out, size_t count) {
+    rng.readBytes(reinterpret_cast<uint8_t*>(out), count * sizeof(double));
+    active_kernels().unit_doubles(out, count);
+}
+
+void Uniform::fillFloats(DRBGReader& rng, float* out, size_t count) {
+    rng.readBytes(reinterpret_cast<uint8_t*>(out), count * sizeof(float));
+    active_kernels().unit_floats(out, count);
+}
+
+std::string Uniform::kernelName() {
+    return active_kernels().name;
+}
+
+// ============================================================================
+// Normal Implementation
+// ============================================================================
+
+double Normal::sample(DRBGReader& rng) {
+    return normal_from(rng, rng.nextUint64());
+}
+
+void Normal::fill(DRBGReader& rng, double* out, size_t count, double mean, double stddev) {
+    if (!(stddev > 0.0)) {
+        throw std::invalid_argument("Normal::fill: stddev must be positive");
+    }
+    rng.readBytes(reinterpret_cast<uint8_t*>(out), count * sizeof(double));
+
+    const ZigguratTables& z = ziggurat();
+    NormalFn kernel = active_kernels().normal;
+    size_t i = 0;
+    while (i < count) {
+        i += kernel(out + i, count - i, z);
+        // Wedge, tail or the last partial block: finish it one draw at a time
+        size_t end = std::min(count, i + NORMAL_BLOCK);
+        for (; i < end; ++i) {
+            uint64_t word;
+            std::memcpy(&word, &out[i], sizeof(word));
+            out[i] = normal_from(rng, word);
+        }
+    }
+
+    if (mean != 0.0 || stddev != 1.0) {
+        for (size_t j = 0; j < count; ++j) {
+            out[j] = mean + stddev * out[j];
+        }
+    }
+}
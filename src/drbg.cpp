@@ -4,209 +4,195 @@
  */
 
 #include "drbg.hpp"
+#include "sha256.hpp"
+#include "kat.hpp"
+#include "sbox_circuit.hpp"
+#include "spn_bitslice.hpp"
 #include <stdexcept>
 #include <algorithm>
+#include <thread>
 
 // ============================================================================
-// SHA-256 Constants and Implementation
+// Threading Helpers
 // ============================================================================
 
 namespace {
-    // SHA-256 constants
-    constexpr uint32_t SHA256_K[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-        0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-        0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-        0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-        0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-        0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
-
-    inline uint32_t rotr(uint32_t x, int n) {
-        return (x >> n) | (x << (32 - n));
-    }
-
-    inline uint32_t ch(uint32_t x, uint32_t y, uint32_t z) {
-        return (x & y) ^ (~x & z);
-    }
-
-    inline uint32_t maj(uint32_t x, uint32_t y, uint32_t z) {
-        return (x & y) ^ (x & z) ^ (y & z);
-    }
-
-    inline uint32_t sigma0(uint32_t x) {
-        return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22);
-    }
-
-    inline uint32_t sigma1(uint32_t x) {
-        return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25);
-    }
-
-    inline uint32_t gamma0(uint32_t x) {
-        return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3);
-    }
-
-    inline uint32_t gamma1(uint32_t x) {
-        return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10);
-    }
-}
-
-std::array<uint8_t, 32> Hash_DRBG::sha256(const std::vector<uint8_t>& data) {
-    // Initial hash values
-    uint32_t h[8] = {
-        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
-    };
-
-    // Pre-processing: adding padding bits
-    std::vector<uint8_t> padded = data;
-    size_t original_len = data.size();
-    size_t original_bit_len = original_len * 8;
-    
-    padded.push_back(0x80);
-    while ((padded.size() % 64) != 56) {
-        padded.push_back(0x00);
-    }
-    
-    // Append length in bits as 64-bit big-endian
-    for (int i = 7; i >= 0; --i) {
-        padded.push_back(static_cast<uint8_t>((original_bit_len >> (i * 8)) & 0xFF));
-    }
-
-    // Process each 512-bit block
-    for (size_t chunk = 0; chunk < padded.size(); chunk += 64) {
-        uint32_t w[64];
-        
-        // Copy chunk into first 16 words
-        for (int i = 0; i < 16; ++i) {
-            w[i] = (static_cast<uint32_t>(padded[chunk + i * 4]) << 24) |
-                   (static_cast<uint32_t>(padded[chunk + i * 4 + 1]) << 16) |
-                   (static_cast<uint32_t>(padded[chunk + i * 4 + 2]) << 8) |
-                   (static_cast<uint32_t>(padded[chunk + i * 4 + 3]));
+    /**
+     * Call fn(start, count) over [0, num_items) cut into at most `threads`
+     * contiguous ranges whose starts are multiples of granularity. Workers
+     * take the leading ranges; the calling thread takes the last one.
+     */
+    template <typename Fn>
+    void for_each_range(size_t num_items, size_t threads, size_t granularity, Fn fn) {
+        if (threads <= 1) {
+            fn(0, num_items);
+            return;
         }
         
-        // Extend to 64 words
-        for (int i = 16; i < 64; ++i) {
-            w[i] = gamma1(w[i-2]) + w[i-7] + gamma0(w[i-15]) + w[i-16];
+        size_t per_thread = ((num_items + threads - 1) / threads + granularity - 1) / granularity * granularity;
+        std::vector<std::thread> workers;
+        size_t start = 0;
+        while (num_items - start > per_thread) {
+            workers.emplace_back(fn, start, per_thread);
+            start += per_thread;
         }
-
-        // Initialize working variables
-        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
-        uint32_t e = h[4], f = h[5], g = h[6], hh = h[7];
-
-        // Compression function
-        for (int i = 0; i < 64; ++i) {
-            uint32_t t1 = hh + sigma1(e) + ch(e, f, g) + SHA256_K[i] + w[i];
-            uint32_t t2 = sigma0(a) + maj(a, b, c);
-            hh = g;
-            g = f;
-            f = e;
-            e = d + t1;
-            d = c;
-            c = b;
-            b = a;
-            a = t1 + t2;
+        fn(start, num_items - start);
+        
+        for (auto& worker : workers) {
+            worker.join();
         }
-
-        // Add to hash
-        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
-        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
     }
-
-    // Produce final hash
-    std::array<uint8_t, 32> result;
-    for (int i = 0; i < 8; ++i) {
-        result[i * 4] = static_cast<uint8_t>((h[i] >> 24) & 0xFF);
-        result[i * 4 + 1] = static_cast<uint8_t>((h[i] >> 16) & 0xFF);
-        result[i * 4 + 2] = static_cast<uint8_t>((h[i] >> 8) & 0xFF);
-        result[i * 4 + 3] = static_cast<uint8_t>(h[i] & 0xFF);
-    }
-    
-    return result;
 }
 
-std::array<uint8_t, 32> HMAC_DRBG::sha256(const std::vector<uint8_t>& data) {
-    return Hash_DRBG::sha256(data);
+// ============================================================================
+// SHA-256 Wrapper
+// ============================================================================
+
+std::array<uint8_t, 32> Hash_DRBG::sha256(const std::vector<uint8_t>& data) {
+    return SHA256::hash(data.data(), data.size());
 }
 
 // ============================================================================
 // CTR-DRBG Implementation
 // ============================================================================
 
-CTR_DRBG::CTR_DRBG(const std::vector<uint8_t>& seed) {
+using ctr_drbg_detail::load_le32;
+using ctr_drbg_detail::store_le32;
+using ctr_drbg_detail::mix_column;
+
+// MixColumns is linear, so a column's output is the XOR of the contributions
+// of its four bytes; each table folds in the S-box for one byte position.
+constexpr CTR_DRBG::TTableSet CTR_DRBG::make_ttables() {
+    TTableSet tables = {};
+    for (size_t j = 0; j < 4; ++j) {
+        for (size_t x = 0; x < 256; ++x) {
+            tables[j][x] = mix_column(static_cast<uint32_t>(SBOX[x]) << (8 * j));
+        }
+    }
+    return tables;
+}
+
+constexpr CTR_DRBG::TTableSet CTR_DRBG::TTABLES = CTR_DRBG::make_ttables();
+
+CTR_DRBG::CTR_DRBG(const std::vector<uint8_t>& seed, Cipher impl) : cipher(impl), num_threads(1) {
+    if (cipher == Cipher::Bitsliced && !spn_bitslice::available()) {
+        cipher = Cipher::Reference;
+    }
     key.fill(0);
     counter.fill(0);
     reseed_counter = 1;
+    round_keys = expand_key(key);
     
     // Initial update with seed
     update(seed);
 }
 
-std::array<uint8_t, CTR_DRBG::BLOCK_SIZE> CTR_DRBG::encrypt_block(
-    const std::array<uint8_t, BLOCK_SIZE>& block) {
-    
-    std::array<uint8_t, BLOCK_SIZE> state = block;
+template <size_t Lanes>
+void CTR_DRBG::encrypt_ttable(const uint8_t* in, uint8_t* out) const {
+    uint32_t s0[Lanes], s1[Lanes], s2[Lanes], s3[Lanes];
+    for (size_t l = 0; l < Lanes; ++l) {
+        const uint8_t* block = in + l * BLOCK_SIZE;
+        s0[l] = load_le32(block) ^ round_keys[0];
+        s1[l] = load_le32(block + 4) ^ round_keys[1];
+        s2[l] = load_le32(block + 8) ^ round_keys[2];
+        s3[l] = load_le32(block + 12) ^ round_keys[3];
+    }
     
-    // Simple SPN cipher: 10 rounds
-    for (int round = 0; round < 10; ++round) {
-        // Add round key (derived from main key)
-        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-            state[i] ^= key[(round * BLOCK_SIZE + i) % KEY_SIZE];
-        }
-        
-        // SubBytes (S-box substitution)
-        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-            state[i] = SBOX[state[i]];
-        }
-        
-        // ShiftRows (simplified permutation)
-        std::array<uint8_t, BLOCK_SIZE> temp = state;
-        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-            state[i] = temp[(i + (i / 4)) % BLOCK_SIZE];
-        }
-        
-        // MixColumns (simplified linear transformation)
-        if (round < 9) {  // Skip in last round
-            for (size_t i = 0; i < BLOCK_SIZE; i += 4) {
-                uint8_t t = state[i] ^ state[i+1] ^ state[i+2] ^ state[i+3];
-                uint8_t u = state[i];
-                state[i] ^= t ^ ((state[i] ^ state[i+1]) << 1);
-                state[i+1] ^= t ^ ((state[i+1] ^ state[i+2]) << 1);
-                state[i+2] ^= t ^ ((state[i+2] ^ state[i+3]) << 1);
-                state[i+3] ^= t ^ ((state[i+3] ^ u) << 1);
-            }
+    // Output column c reads input bytes (5c + j) % 16: columns 0..2 take one
+    // byte-aligned run each, column 3 wraps around to bytes 15, 0, 1, 2
+    for (int round = 1; round < ROUNDS; ++round) {
+        const uint32_t* rk = &round_keys[round * BLOCK_WORDS];
+#pragma GCC unroll 4
+        for (size_t l = 0; l < Lanes; ++l) {
+            uint32_t t0 = TTABLES[0][s0[l] & 0xFF] ^ TTABLES[1][(s0[l] >> 8) & 0xFF] ^
+                          TTABLES[2][(s0[l] >> 16) & 0xFF] ^ TTABLES[3][s0[l] >> 24];
+            uint32_t t1 = TTABLES[0][(s1[l] >> 8) & 0xFF] ^ TTABLES[1][(s1[l] >> 16) & 0xFF] ^
+                          TTABLES[2][s1[l] >> 24] ^ TTABLES[3][s2[l] & 0xFF];
+            uint32_t t2 = TTABLES[0][(s2[l] >> 16) & 0xFF] ^ TTABLES[1][s2[l] >> 24] ^
+                          TTABLES[2][s3[l] & 0xFF] ^ TTABLES[3][(s3[l] >> 8) & 0xFF];
+            uint32_t t3 = TTABLES[0][s3[l] >> 24] ^ TTABLES[1][s0[l] & 0xFF] ^
+                          TTABLES[2][(s0[l] >> 8) & 0xFF] ^ TTABLES[3][(s0[l] >> 16) & 0xFF];
+            s0[l] = t0 ^ rk[0];
+            s1[l] = t1 ^ rk[1];
+            s2[l] = t2 ^ rk[2];
+            s3[l] = t3 ^ rk[3];
         }
     }
     
-    return state;
+    // Last round: SubBytes and permutation only
+    auto sb = [](uint32_t w, int byte) { return static_cast<uint32_t>(SBOX[(w >> (8 * byte)) & 0xFF]); };
+    for (size_t l = 0; l < Lanes; ++l) {
+        uint8_t* block = out + l * BLOCK_SIZE;
+        store_le32(block, sb(s0[l], 0) | (sb(s0[l], 1) << 8) | (sb(s0[l], 2) << 16) | (sb(s0[l], 3) << 24));
+        store_le32(block + 4, sb(s1[l], 1) | (sb(s1[l], 2) << 8) | (sb(s1[l], 3) << 16) | (sb(s2[l], 0) << 24));
+        store_le32(block + 8, sb(s2[l], 2) | (sb(s2[l], 3) << 8) | (sb(s3[l], 0) << 16) | (sb(s3[l], 1) << 24));
+        store_le32(block + 12, sb(s3[l], 3) | (sb(s0[l], 0) << 8) | (sb(s0[l], 1) << 16) | (sb(s0[l], 2) << 24));
+    }
 }
 
-void CTR_DRBG::increment_counter() {
+void CTR_DRBG::increment_counter(std::array<uint8_t, BLOCK_SIZE>& ctr) {
     for (int i = BLOCK_SIZE - 1; i >= 0; --i) {
-        if (++counter[i] != 0) break;
+        if (++ctr[i] != 0) break;
     }
 }
 
-void CTR_DRBG::update(const std::vector<uint8_t>& provided_data) {
-    std::vector<uint8_t> temp;
+void CTR_DRBG::advance_counter(std::array<uint8_t, BLOCK_SIZE>& ctr, uint64_t blocks) {
+    uint64_t carry = blocks;
+    for (int i = BLOCK_SIZE - 1; i >= 0 && carry != 0; --i) {
+        carry += ctr[i];
+        ctr[i] = static_cast<uint8_t>(carry);
+        carry >>= 8;
+    }
+}
+
+void CTR_DRBG::encrypt_range(std::array<uint8_t, BLOCK_SIZE>& ctr, uint8_t* out, size_t num_blocks) const {
+    if (cipher == Cipher::Bitsliced) {
+        spn_bitslice::keystream(round_keys.data(), ROUNDS, ctr.data(), out, num_blocks);
+        return;
+    }
     
-    // Generate enough blocks to fill key + counter
-    while (temp.size() < KEY_SIZE + BLOCK_SIZE) {
-        increment_counter();
-        auto block = encrypt_block(counter);
-        temp.insert(temp.end(), block.begin(), block.end());
+    // Materialize INTERLEAVE counters, then encrypt them together straight
+    // into the output
+    std::array<uint8_t, INTERLEAVE * BLOCK_SIZE> counters;
+    size_t n = 0;
+    for (; n + INTERLEAVE <= num_blocks; n += INTERLEAVE) {
+        for (size_t l = 0; l < INTERLEAVE; ++l) {
+            increment_counter(ctr);
+            std::copy(ctr.begin(), ctr.end(), counters.begin() + l * BLOCK_SIZE);
+        }
+        encrypt<INTERLEAVE>(counters.data(), out + n * BLOCK_SIZE);
     }
     
+    for (; n < num_blocks; ++n) {
+        increment_counter(ctr);
+        encrypt<1>(ctr.data(), out + n * BLOCK_SIZE);
+    }
+}
+
+void CTR_DRBG::keystream(uint8_t* out, size_t num_blocks) {
+    // Ranges are rounded to whole bit-sliced batches
+    size_t threads = std::min(num_threads, num_blocks / PARALLEL_MIN_BLOCKS);
+    for_each_range(num_blocks, threads, spn_bitslice::BATCH_BLOCKS, [this, out](size_t start, size_t count) {
+        std::array<uint8_t, BLOCK_SIZE> ctr = counter;
+        advance_counter(ctr, start);
+        encrypt_range(ctr, out + start * BLOCK_SIZE, count);
+    });
+    advance_counter(counter, num_blocks);
+}
+
+void CTR_DRBG::setThreadCount(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = threads;
+}
+
+void CTR_DRBG::update(const std::vector<uint8_t>& provided_data) {
+    // Generate enough blocks to fill key + counter
+    static_assert((KEY_SIZE + BLOCK_SIZE) % BLOCK_SIZE == 0, "update consumes whole blocks");
+    std::array<uint8_t, KEY_SIZE + BLOCK_SIZE> temp;
+    keystream(temp.data(), temp.size() / BLOCK_SIZE);
+    
     // XOR with provided data
     for (size_t i = 0; i < std::min(temp.size(), provided_data.size()); ++i) {
         temp[i] ^= provided_data[i];
@@ -215,26 +201,26 @@ void CTR_DRBG::update(const std::vector<uint8_t>& provided_data) {
     // Update key and counter
     std::copy(temp.begin(), temp.begin() + KEY_SIZE, key.begin());
     std::copy(temp.begin() + KEY_SIZE, temp.begin() + KEY_SIZE + BLOCK_SIZE, counter.begin());
+    round_keys = expand_key(key);
 }
 
-std::vector<uint8_t> CTR_DRBG::generate(size_t num_bits) {
+void CTR_DRBG::generateInto(uint8_t* out, size_t num_bits) {
     size_t num_bytes = (num_bits + 7) / 8;
-    std::vector<uint8_t> result;
-    result.reserve(num_bytes);
+    size_t full_blocks = num_bytes / BLOCK_SIZE;
     
-    while (result.size() < num_bytes) {
-        increment_counter();
-        auto block = encrypt_block(counter);
-        result.insert(result.end(), block.begin(), block.end());
-    }
+    keystream(out, full_blocks);
     
-    result.resize(num_bytes);
+    // A partial last block goes through a local buffer
+    size_t tail = num_bytes % BLOCK_SIZE;
+    if (tail > 0) {
+        std::array<uint8_t, BLOCK_SIZE> last;
+        keystream(last.data(), 1);
+        std::copy(last.begin(), last.begin() + tail, out + full_blocks * BLOCK_SIZE);
+    }
     
     // Update state
     update({});
     reseed_counter++;
-    
-    return result;
 }
 
 void CTR_DRBG::reseed(const std::vector<uint8_t>& seed) {
@@ -242,122 +228,329 @@ void CTR_DRBG::reseed(const std::vector<uint8_t>& seed) {
     reseed_counter = 1;
 }
 
+// ============================================================================
+// AES-256 CTR-DRBG Implementation (SP 800-90A 10.2)
+// ============================================================================
+
+AES_CTR_DRBG::AES_CTR_DRBG(const std::vector<uint8_t>& seed) {
+    key.fill(0);
+    V.fill(0);
+    round_keys = AES256::expandKey(key);
+    update(block_cipher_df(seed));
+    reseed_counter = 1;
+}
+
+AES_CTR_DRBG::SeedMaterial AES_CTR_DRBG::block_cipher_df(const std::vector<uint8_t>& input) {
+    if (input.size() > 0xFFFFFFFFu) {
+        throw std::invalid_argument("AES_CTR_DRBG: derivation function input too long");
+    }
+
+    // S = L || N || input || 0x80, zero-padded to whole blocks
+    // (L and N are 32-bit big-endian byte counts)
+    std::vector<uint8_t> S;
+    S.reserve(8 + input.size() + BLOCK_SIZE);
+    uint32_t L = static_cast<uint32_t>(input.size());
+    uint32_t N = static_cast<uint32_t>(SEED_LENGTH);
+    for (int i = 3; i >= 0; --i) S.push_back(static_cast<uint8_t>(L >> (i * 8)));
+    for (int i = 3; i >= 0; --i) S.push_back(static_cast<uint8_t>(N >> (i * 8)));
+    S.insert(S.end(), input.begin(), input.end());
+    S.push_back(0x80);
+    S.resize((S.size() + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE, 0);
+
+    // temp = BCC(K, IV_i || S) for i = 0, 1, 2 with K = 00 01 .. 1f
+    AES256::Key df_key;
+    for (size_t i = 0; i < KEY_SIZE; ++i) {
+        df_key[i] = static_cast<uint8_t>(i);
+    }
+    const AES256::RoundKeys df_round_keys = AES256::expandKey(df_key);
+
+    SeedMaterial temp;
+    for (uint32_t i = 0; i < SEED_LENGTH / BLOCK_SIZE; ++i) {
+        // IV_i is i as a 32-bit big-endian integer, zero-padded to a block;
+        // the chaining value starts at zero, so the first input is IV_i itself
+        AES256::Block chain = {};
+        for (int b = 0; b < 4; ++b) {
+            chain[b] = static_cast<uint8_t>(i >> ((3 - b) * 8));
+        }
+        chain = AES256::encryptBlock(df_round_keys, chain);
+        for (size_t offset = 0; offset < S.size(); offset += BLOCK_SIZE) {
+            for (size_t b = 0; b < BLOCK_SIZE; ++b) {
+                chain[b] ^= S[offset + b];
+            }
+            chain = AES256::encryptBlock(df_round_keys, chain);
+        }
+        std::copy(chain.begin(), chain.end(), temp.begin() + i * BLOCK_SIZE);
+    }
+
+    // Re-key with the leftmost keylen bits and chain-encrypt X
+    AES256::Key new_key;
+    std::copy(temp.begin(), temp.begin() + KEY_SIZE, new_key.begin());
+    const AES256::RoundKeys new_round_keys = AES256::expandKey(new_key);
+    AES256::Block X;
+    std::copy(temp.begin() + KEY_SIZE, temp.end(), X.begin());
+
+    SeedMaterial result;
+    for (size_t offset = 0; offset < SEED_LENGTH; offset += BLOCK_SIZE) {
+        X = AES256::encryptBlock(new_round_keys, X);
+        std::copy(X.begin(), X.end(), result.begin() + offset);
+    }
+    return result;
+}
+
+void AES_CTR_DRBG::update(const SeedMaterial& provided_data) {
+    SeedMaterial temp;
+    AES256::ctrKeystream(round_keys, V.data(), temp.data(), SEED_LENGTH / BLOCK_SIZE);
+
+    for (size_t i = 0; i < SEED_LENGTH; ++i) {
+        temp[i] ^= provided_data[i];
+    }
+
+    std::copy(temp.begin(), temp.begin() + KEY_SIZE, key.begin());
+    std::copy(temp.begin() + KEY_SIZE, temp.end(), V.begin());
+    round_keys = AES256::expandKey(key);
+}
+
+void AES_CTR_DRBG::generateInto(uint8_t* out, size_t num_bits) {
+    static_assert(MAX_REQUEST_BYTES % BLOCK_SIZE == 0, "requests must end on block boundaries");
+
+    size_t num_bytes = (num_bits + 7) / 8;
+    size_t offset = 0;
+    do {
+        if (reseed_counter > RESEED_INTERVAL) {
+            throw std::runtime_error("AES_CTR_DRBG: reseed required");
+        }
+        size_t request_bytes = std::min(MAX_REQUEST_BYTES, num_bytes - offset);
+        size_t full_blocks = request_bytes / BLOCK_SIZE;
+        AES256::ctrKeystream(round_keys, V.data(), out + offset, full_blocks);
+        offset += full_blocks * BLOCK_SIZE;
+
+        // A partial last block goes through a local buffer
+        size_t tail = request_bytes % BLOCK_SIZE;
+        if (tail > 0) {
+            AES256::Block last;
+            AES256::ctrKeystream(round_keys, V.data(), last.data(), 1);
+            std::copy(last.begin(), last.begin() + tail, out + offset);
+            offset += tail;
+        }
+
+        // No additional input: update with seedlen zero bits
+        update(SeedMaterial{});
+        reseed_counter++;
+    } while (offset < num_bytes);
+}
+
+void AES_CTR_DRBG::reseed(const std::vector<uint8_t>& seed) {
+    update(block_cipher_df(seed));
+    reseed_counter = 1;
+}
+
 // ============================================================================
 // Hash-DRBG Implementation
 // ============================================================================
 
-Hash_DRBG::Hash_DRBG(const std::vector<uint8_t>& seed) {
-    // Hash_df to derive initial state
-    V = hash_df(seed, SEED_LENGTH * 8);
-    
-    // Derive C
-    std::vector<uint8_t> c_input = {0x00};
-    c_input.insert(c_input.end(), V.begin(), V.end());
-    C = hash_df(c_input, SEED_LENGTH * 8);
-    
+Hash_DRBG::Hash_DRBG(const std::vector<uint8_t>& seed) : num_threads(1) {
+    derive_state(seed);
     reseed_counter = 1;
 }
 
-std::vector<uint8_t> Hash_DRBG::hash_df(const std::vector<uint8_t>& input, size_t no_of_bits) {
+std::vector<uint8_t> Hash_DRBG::hashDf(const std::vector<uint8_t>& input, size_t no_of_bits) {
     size_t no_of_bytes = (no_of_bits + 7) / 8;
     size_t len = (no_of_bytes + HASH_OUTPUT - 1) / HASH_OUTPUT;
     
-    std::vector<uint8_t> temp;
+    std::vector<uint8_t> temp(len * HASH_OUTPUT);
     uint8_t counter = 1;
     
+    // no_of_bits as 32-bit big-endian
+    const uint8_t bits_be[4] = {
+        static_cast<uint8_t>((no_of_bits >> 24) & 0xFF),
+        static_cast<uint8_t>((no_of_bits >> 16) & 0xFF),
+        static_cast<uint8_t>((no_of_bits >> 8) & 0xFF),
+        static_cast<uint8_t>(no_of_bits & 0xFF)
+    };
+    
     for (size_t i = 0; i < len; ++i) {
-        std::vector<uint8_t> hash_input;
-        hash_input.push_back(counter++);
+        // Hash(counter || no_of_bits || input)
+        SHA256 ctx;
+        ctx.update(counter++);
+        ctx.update(bits_be, sizeof(bits_be));
+        ctx.update(input);
         
-        // no_of_bits as 32-bit big-endian
-        hash_input.push_back(static_cast<uint8_t>((no_of_bits >> 24) & 0xFF));
-        hash_input.push_back(static_cast<uint8_t>((no_of_bits >> 16) & 0xFF));
-        hash_input.push_back(static_cast<uint8_t>((no_of_bits >> 8) & 0xFF));
-        hash_input.push_back(static_cast<uint8_t>(no_of_bits & 0xFF));
-        
-        hash_input.insert(hash_input.end(), input.begin(), input.end());
-        
-        auto hash = sha256(hash_input);
-        temp.insert(temp.end(), hash.begin(), hash.end());
+        auto hash = ctx.finalize();
+        std::copy(hash.begin(), hash.end(), temp.begin() + i * HASH_OUTPUT);
     }
     
     temp.resize(no_of_bytes);
     return temp;
 }
 
-void Hash_DRBG::add_to_V(const std::vector<uint8_t>& value) {
-    // Add value to V (modular addition treating as big integer)
-    uint16_t carry = 0;
-    size_t min_len = std::min(V.size(), value.size());
+void Hash_DRBG::derive_state(const std::vector<uint8_t>& seed_material) {
+    V.fill(0);
+    C.fill(0);
+    
+    auto v = hashDf(seed_material, SEED_LENGTH * 8);
+    std::copy(v.begin(), v.end(), V.begin() + PAD);
+    
+    // C = Hash_df(0x00 || V)
+    std::vector<uint8_t> c_input = {0x00};
+    c_input.insert(c_input.end(), v.begin(), v.end());
+    auto c = hashDf(c_input, SEED_LENGTH * 8);
+    std::copy(c.begin(), c.end(), C.begin() + PAD);
+}
+
+void Hash_DRBG::update_V(const SHA256::Digest& H) {
+    auto load_be64 = [](const uint8_t* p) {
+        uint64_t w = 0;
+        for (int i = 0; i < 8; ++i) {
+            w = (w << 8) | p[i];
+        }
+        return w;
+    };
     
-    for (size_t i = 0; i < V.size(); ++i) {
-        size_t idx = V.size() - 1 - i;
-        size_t val_idx = value.size() - 1 - i;
+    // Limb k (least significant first) covers bytes [8 * (LIMBS - 1 - k), +8).
+    // H spans the low four limbs and reseed_counter the lowest; the sum of
+    // four limbs plus carry fits in 128 bits, and the carry out is at most 3.
+    static_assert(SHA256::DIGEST_SIZE % 8 == 0 && SHA256::DIGEST_SIZE / 8 <= LIMBS,
+                  "H must cover whole low limbs");
+    constexpr size_t H_LIMBS = SHA256::DIGEST_SIZE / 8;
+    uint64_t carry = 0;
+    for (size_t k = 0; k < LIMBS; ++k) {
+        const size_t offset = 8 * (LIMBS - 1 - k);
+        unsigned __int128 sum = static_cast<unsigned __int128>(load_be64(&V[offset])) +
+                                load_be64(&C[offset]) + carry;
+        if (k < H_LIMBS) {
+            sum += load_be64(&H[8 * (H_LIMBS - 1 - k)]);
+        }
+        if (k == 0) {
+            sum += reseed_counter;
+        }
         
-        uint16_t sum = static_cast<uint16_t>(V[idx]) + carry;
-        if (i < min_len) {
-            sum += static_cast<uint16_t>(value[val_idx]);
+        uint64_t limb = static_cast<uint64_t>(sum);
+        carry = static_cast<uint64_t>(sum >> 64);
+        for (int i = 7; i >= 0; --i) {
+            V[offset + i] = static_cast<uint8_t>(limb);
+            limb >>= 8;
         }
-        V[idx] = static_cast<uint8_t>(sum & 0xFF);
-        carry = sum >> 8;
     }
+    
+    // Reduce mod 2^seedlen: drop whatever carried into the pad bytes
+    std::fill(V.begin(), V.begin() + PAD, 0);
 }
 
-std::vector<uint8_t> Hash_DRBG::hashgen(size_t requested_bits) {
-    size_t m = (requested_bits + (HASH_OUTPUT * 8) - 1) / (HASH_OUTPUT * 8);
-    std::vector<uint8_t> data = V;
-    std::vector<uint8_t> W;
-    
-    for (size_t i = 0; i < m; ++i) {
-        auto w = sha256(data);
-        W.insert(W.end(), w.begin(), w.end());
+void Hash_DRBG::offset_data(uint8_t* data, uint64_t blocks) {
+    uint64_t carry = blocks;
+    for (size_t j = SEED_LENGTH; j-- > 0 && carry != 0;) {
+        carry += data[j];
+        data[j] = static_cast<uint8_t>(carry);
+        carry >>= 8;
+    }
+}
+
+void Hash_DRBG::hashgen_range(const uint8_t* v, uint64_t first, uint8_t* out, size_t num_blocks) {
+    // A seedlen-byte message pads to exactly one SHA-256 block. Build that
+    // block once; each output then costs one compression plus an in-place
+    // add to the message bytes, which usually touches only the last byte.
+    static_assert(SEED_LENGTH + 1 + 8 <= SHA256::BLOCK_SIZE,
+                  "Hash_DRBG data must pad to a single SHA-256 block");
+    std::array<uint8_t, SHA256::BLOCK_SIZE> block = {};
+    std::copy(v, v + SEED_LENGTH, block.begin());
+    block[SEED_LENGTH] = 0x80;
+    const uint64_t bit_len = SEED_LENGTH * 8;
+    for (int k = 0; k < 8; ++k) {
+        block[SHA256::BLOCK_SIZE - 1 - k] = static_cast<uint8_t>((bit_len >> (k * 8)) & 0xFF);
+    }
+    offset_data(block.data(), first);
+    
+    size_t i = 0;
+    
+    // Multi-buffer path: the blocks Hash(data + i) are independent, so a
+    // group of them can be compressed side by side in SIMD lanes; lane j
+    // starts at data + j and steps by the lane count
+    constexpr size_t MAX_LANES = 8;
+    const size_t lanes = SHA256::multiBufferLanes();
+    if (lanes > 1 && lanes <= MAX_LANES && num_blocks >= lanes) {
+        std::array<uint8_t, MAX_LANES * SHA256::BLOCK_SIZE> blocks;
+        std::array<SHA256::State, MAX_LANES> states;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            std::copy(block.begin(), block.end(), blocks.begin() + lane * SHA256::BLOCK_SIZE);
+            offset_data(&blocks[lane * SHA256::BLOCK_SIZE], lane);
+        }
         
-        // Increment data
-        for (int j = static_cast<int>(data.size()) - 1; j >= 0; --j) {
-            if (++data[j] != 0) break;
+        for (; i + lanes <= num_blocks; i += lanes) {
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                states[lane] = SHA256::INITIAL_STATE;
+            }
+            
+            SHA256::compressLanes(states.data(), blocks.data(), lanes);
+            
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                SHA256::storeDigest(states[lane], out + (i + lane) * HASH_OUTPUT);
+                offset_data(&blocks[lane * SHA256::BLOCK_SIZE], lanes);
+            }
         }
+        offset_data(block.data(), i);
     }
     
-    W.resize((requested_bits + 7) / 8);
-    return W;
+    // Remaining blocks one at a time
+    for (; i < num_blocks; ++i) {
+        SHA256::State state = SHA256::INITIAL_STATE;
+        SHA256::compress(state.data(), block.data(), 1);
+        SHA256::storeDigest(state, out + i * HASH_OUTPUT);
+        offset_data(block.data(), 1);
+    }
+}
+
+void Hash_DRBG::hashgen(uint8_t* out, size_t requested_bits) {
+    size_t num_bytes = (requested_bits + 7) / 8;
+    size_t full_blocks = num_bytes / HASH_OUTPUT;
+    
+    // Block i is Hash(V + i), so each range starts from its own offset of V;
+    // ranges are rounded to whole multi-buffer groups
+    size_t threads = std::min(num_threads, full_blocks / PARALLEL_MIN_BLOCKS);
+    for_each_range(full_blocks, threads, SHA256::multiBufferLanes(), [this, out](size_t start, size_t count) {
+        hashgen_range(v_bytes(), start, out + start * HASH_OUTPUT, count);
+    });
+    
+    // A partial last block goes through a local buffer
+    size_t tail = num_bytes % HASH_OUTPUT;
+    if (tail > 0) {
+        std::array<uint8_t, HASH_OUTPUT> last;
+        hashgen_range(v_bytes(), full_blocks, last.data(), 1);
+        std::copy(last.begin(), last.begin() + tail, out + full_blocks * HASH_OUTPUT);
+    }
 }
 
-std::vector<uint8_t> Hash_DRBG::generate(size_t num_bits) {
+void Hash_DRBG::setThreadCount(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = threads;
+}
+
+void Hash_DRBG::generateInto(uint8_t* out, size_t num_bits) {
     // Generate random bits
-    auto returned_bits = hashgen(num_bits);
-    
-    // Update state
-    std::vector<uint8_t> H_input = {0x03};
-    H_input.insert(H_input.end(), V.begin(), V.end());
-    auto H = sha256(H_input);
+    hashgen(out, num_bits);
+    update_state();
+}
+
+void Hash_DRBG::update_state() {
+    // H = Hash(0x03 || V)
+    SHA256 ctx;
+    ctx.update(static_cast<uint8_t>(0x03));
+    ctx.update(v_bytes(), SEED_LENGTH);
+    auto H = ctx.finalize();
     
     // V = V + H + C + reseed_counter
-    add_to_V(std::vector<uint8_t>(H.begin(), H.end()));
-    add_to_V(C);
-    
-    // Add reseed_counter
-    std::vector<uint8_t> rc_bytes(8);
-    for (int i = 7; i >= 0; --i) {
-        rc_bytes[7 - i] = static_cast<uint8_t>((reseed_counter >> (i * 8)) & 0xFF);
-    }
-    add_to_V(rc_bytes);
+    update_V(H);
     
     reseed_counter++;
-    
-    return returned_bits;
 }
 
 void Hash_DRBG::reseed(const std::vector<uint8_t>& seed) {
     std::vector<uint8_t> seed_material = {0x01};
-    seed_material.insert(seed_material.end(), V.begin(), V.end());
+    seed_material.insert(seed_material.end(), v_bytes(), v_bytes() + SEED_LENGTH);
     seed_material.insert(seed_material.end(), seed.begin(), seed.end());
     
-    V = hash_df(seed_material, SEED_LENGTH * 8);
-    
-    std::vector<uint8_t> c_input = {0x00};
-    c_input.insert(c_input.end(), V.begin(), V.end());
-    C = hash_df(c_input, SEED_LENGTH * 8);
-    
+    derive_state(seed_material);
     reseed_counter = 1;
 }
 
@@ -365,41 +558,8 @@ void Hash_DRBG::reseed(const std::vector<uint8_t>& seed) {
 // HMAC-DRBG Implementation
 // ============================================================================
 
-std::array<uint8_t, 32> HMAC_DRBG::hmac_sha256(const std::array<uint8_t, 32>& key,
-                                                const std::vector<uint8_t>& data) {
-    static constexpr size_t BLOCK_SIZE = 64;
-    
-    // Prepare key
-    std::array<uint8_t, BLOCK_SIZE> k_pad = {};
-    std::copy(key.begin(), key.end(), k_pad.begin());
-    
-    // Inner padding
-    std::array<uint8_t, BLOCK_SIZE> i_key_pad;
-    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-        i_key_pad[i] = k_pad[i] ^ 0x36;
-    }
-    
-    // Outer padding
-    std::array<uint8_t, BLOCK_SIZE> o_key_pad;
-    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
-        o_key_pad[i] = k_pad[i] ^ 0x5c;
-    }
-    
-    // Inner hash
-    std::vector<uint8_t> inner_data(i_key_pad.begin(), i_key_pad.end());
-    inner_data.insert(inner_data.end(), data.begin(), data.end());
-    auto inner_hash = sha256(inner_data);
-    
-    // Outer hash
-    std::vector<uint8_t> outer_data(o_key_pad.begin(), o_key_pad.end());
-    outer_data.insert(outer_data.end(), inner_hash.begin(), inner_hash.end());
-    
-    return sha256(outer_data);
-}
-
-HMAC_DRBG::HMAC_DRBG(const std::vector<uint8_t>& seed) {
+HMAC_DRBG::HMAC_DRBG(const std::vector<uint8_t>& seed) : K{}, keyed_mac(K) {
     // Initial values
-    K.fill(0x00);
     V.fill(0x01);
     reseed_counter = 1;
     
@@ -407,48 +567,105 @@ HMAC_DRBG::HMAC_DRBG(const std::vector<uint8_t>& seed) {
     update(seed);
 }
 
+void HMAC_DRBG::set_key(const std::array<uint8_t, HASH_OUTPUT>& new_key) {
+    K = new_key;
+    keyed_mac = HMAC_SHA256(K);
+}
+
 void HMAC_DRBG::update(const std::vector<uint8_t>& provided_data) {
     // K = HMAC(K, V || 0x00 || provided_data)
-    std::vector<uint8_t> temp(V.begin(), V.end());
-    temp.push_back(0x00);
-    temp.insert(temp.end(), provided_data.begin(), provided_data.end());
-    K = hmac_sha256(K, temp);
+    HMAC_SHA256 mac = keyed_mac;
+    mac.update(V);
+    mac.update(static_cast<uint8_t>(0x00));
+    mac.update(provided_data);
+    set_key(mac.finalize());
     
     // V = HMAC(K, V)
-    V = hmac_sha256(K, std::vector<uint8_t>(V.begin(), V.end()));
+    mac = keyed_mac;
+    mac.update(V);
+    V = mac.finalize();
     
     if (!provided_data.empty()) {
         // K = HMAC(K, V || 0x01 || provided_data)
-        temp.assign(V.begin(), V.end());
-        temp.push_back(0x01);
-        temp.insert(temp.end(), provided_data.begin(), provided_data.end());
-        K = hmac_sha256(K, temp);
+        mac = keyed_mac;
+        mac.update(V);
+        mac.update(static_cast<uint8_t>(0x01));
+        mac.update(provided_data);
+        set_key(mac.finalize());
         
         // V = HMAC(K, V)
-        V = hmac_sha256(K, std::vector<uint8_t>(V.begin(), V.end()));
+        mac = keyed_mac;
+        mac.update(V);
+        V = mac.finalize();
     }
 }
 
-std::vector<uint8_t> HMAC_DRBG::generate(size_t num_bits) {
+void HMAC_DRBG::generateInto(uint8_t* out, size_t num_bits) {
     size_t num_bytes = (num_bits + 7) / 8;
-    std::vector<uint8_t> result;
-    result.reserve(num_bytes);
     
-    while (result.size() < num_bytes) {
-        V = hmac_sha256(K, std::vector<uint8_t>(V.begin(), V.end()));
-        result.insert(result.end(), V.begin(), V.end());
+    for (size_t offset = 0; offset < num_bytes; offset += HASH_OUTPUT) {
+        // V = HMAC(K, V), resuming from the cached midstates
+        HMAC_SHA256 mac = keyed_mac;
+        mac.update(V);
+        V = mac.finalize();
+        std::copy(V.begin(), V.begin() + std::min(HASH_OUTPUT, num_bytes - offset), out + offset);
     }
     
-    result.resize(num_bytes);
-    
     // Update state
     update({});
     reseed_counter++;
-    
-    return result;
 }
 
 void HMAC_DRBG::reseed(const std::vector<uint8_t>& seed) {
     update(seed);
     reseed_counter = 1;
 }
+
+// ============================================================================
+// Compile-time Known-Answer Tests
+// ============================================================================
+
+// Hash_df producing seedlen bytes, as used to derive V and C. A regression
+// value recorded from this code, cross-checked with Python's hashlib.
+static_assert(kat::matchesHex(Hash_DRBG::hashDfConst<55>(kat::bytes("Hash_DRBG known-answer seed")),
+    "4c5c2e844b980f3f667ee58a7c339d9ab3f1d6cd1e5f6c379485c8170c0386e0"
+    "c31ca6e00852b159974c57cbd6b240cd430e7270d8f89c"),
+    "Hash_df KAT failed");
+
+// The boolean S-box circuit used by the bit-sliced backend equals SBOX
+namespace {
+    constexpr bool sbox_circuit_matches_table() {
+        for (uint32_t chunk = 0; chunk < 8; ++chunk) {
+            // Bit n of plane b: bit b of input byte 32 * chunk + n
+            uint32_t q[8] = {};
+            for (uint32_t n = 0; n < 32; ++n) {
+                for (int b = 0; b < 8; ++b) {
+                    q[b] |= (((chunk * 32 + n) >> b) & 1u) << n;
+                }
+            }
+            aes_sbox_circuit(q);
+            for (uint32_t n = 0; n < 32; ++n) {
+                uint32_t value = 0;
+                for (int b = 0; b < 8; ++b) {
+                    value |= ((q[b] >> n) & 1u) << b;
+                }
+                if (value != CTR_DRBG::SBOX[chunk * 32 + n]) return false;
+            }
+        }
+        return true;
+    }
+}
+static_assert(sbox_circuit_matches_table(), "S-box circuit does not match CTR_DRBG::SBOX");
+
+// SPN cipher: key 00..1f, block 00..0f, and the all-zero key/block. The
+// cipher has no published vectors; these are regression values recorded
+// from this code, which pin the Reference kernel (see encrypt_block()).
+static_assert(kat::matchesHex(CTR_DRBG::encrypt_block(
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+     0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}),
+    "460a4c3e5e2a37a4d7c836455b460a4c"),
+    "SPN KAT failed");
+static_assert(kat::matchesHex(CTR_DRBG::encrypt_block({}, {}),
+    "36363636363636363636363636363636"),
+    "SPN KAT failed (zero key)");
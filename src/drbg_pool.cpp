@@ -0,0 +1,65 @@
+/**
+ * @file drbg_pool.cpp
+ * @brief Non-template helpers for DRBGPool
+ */
+
+#include "drbg_pool.hpp"
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+    std::mutex live_pools_lock;
+    std::unordered_set<uint64_t> live_pools;
+    uint64_t last_pool_id = 0;
+}
+
+namespace drbg_pool_detail {
+    uint64_t register_pool() {
+        std::lock_guard<std::mutex> guard(live_pools_lock);
+        live_pools.insert(++last_pool_id);
+        return last_pool_id;
+    }
+
+    void unregister_pool(uint64_t pool_id) {
+        {
+            std::lock_guard<std::mutex> guard(live_pools_lock);
+            live_pools.erase(pool_id);
+        }
+        destroyed_pools.fetch_add(1, std::memory_order_release);
+    }
+
+    bool pool_alive(uint64_t pool_id) {
+        std::lock_guard<std::mutex> guard(live_pools_lock);
+        return live_pools.count(pool_id) != 0;
+    }
+
+    size_t current_cpu() {
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu);
+        }
+#endif
+        return std::hash<std::thread::id>{}(std::this_thread::get_id());
+    }
+
+    std::vector<uint8_t> shard_seed(DRBG& master, uint64_t shard) {
+        static const char LABEL[] = "DRBGPool/shard/";
+        constexpr size_t LABEL_LENGTH = sizeof(LABEL) - 1;
+
+        std::vector<uint8_t> seed = master.generate(SEED_BYTES * 8);
+        for (size_t i = 0; i < LABEL_LENGTH; ++i) {
+            seed[i] ^= static_cast<uint8_t>(LABEL[i]);
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            seed[LABEL_LENGTH + i] ^= static_cast<uint8_t>(shard >> (56 - 8 * i));
+        }
+        return seed;
+    }
+}
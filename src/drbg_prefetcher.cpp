@@ -0,0 +1,164 @@
+/**
+ * @file drbg_prefetcher.cpp
+ * @brief DRBGPrefetcher ring operations and producer thread
+ */
+
+#include "drbg_prefetcher.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    size_t ring_capacity(size_t num_slots) {
+        size_t capacity = 1;
+        while (capacity < num_slots) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Zero memory that is about to be freed, where a plain memset could be
+    // dropped as a dead store
+    void secure_wipe(uint8_t* data, size_t size) {
+        std::memset(data, 0, size);
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+    }
+}
+
+DRBGPrefetcher::DRBGPrefetcher(DRBG& source, size_t num_slots)
+    : DRBGPrefetcher(source, num_slots, ring_capacity(num_slots) / 4, ring_capacity(num_slots)) {}
+
+DRBGPrefetcher::DRBGPrefetcher(DRBG& source, size_t num_slots, size_t low_watermark,
+                               size_t high_watermark)
+    : source(source), capacity(ring_capacity(num_slots)), low(low_watermark),
+      high(high_watermark), head(0), tail(0), miss_count(0), sleeping(false), stopping(false) {
+    if (low >= high || high > capacity) {
+        throw std::invalid_argument("DRBGPrefetcher: watermarks need low < high <= capacity");
+    }
+    slots.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    producer = std::thread(&DRBGPrefetcher::produce, this);
+}
+
+DRBGPrefetcher::~DRBGPrefetcher() {
+    {
+        std::lock_guard<std::mutex> guard(wake_lock);
+        stopping.store(true);
+    }
+    wake.notify_one();
+    producer.join();
+    for (size_t i = 0; i < capacity; ++i) {
+        secure_wipe(slots[i].data, SLOT_BYTES);
+    }
+}
+
+size_t DRBGPrefetcher::available() const {
+    // seq_cst: the producer's sleep check relies on it (see produce())
+    uint64_t consumed = head.load();
+    uint64_t filled = tail.load();
+    return (filled > consumed) ? static_cast<size_t>(filled - consumed) : 0;
+}
+
+bool DRBGPrefetcher::take(uint8_t* out, size_t num_bytes) {
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[pos & (capacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - (pos + 1));
+        if (lag == 0) {
+            // seq_cst pairs with the producer's sleeping flag in wake_if_low()
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+                std::memcpy(out, slot.data, num_bytes);
+                std::memset(slot.data, 0, SLOT_BYTES);
+                slot.sequence.store(pos + capacity, std::memory_order_release);
+                return true;
+            }
+        } else if (lag < 0) {
+            return false;  // Not filled yet
+        } else {
+            pos = head.load(std::memory_order_relaxed);  // Another consumer took it
+        }
+    }
+}
+
+void DRBGPrefetcher::generateInto(uint8_t* out, size_t num_bits) {
+    size_t remaining = (num_bits + 7) / 8;
+    if (remaining > MAX_PREFETCHED_BYTES) {
+        std::lock_guard<std::mutex> guard(source_lock);
+        source.generateInto(out, num_bits);
+        return;
+    }
+    while (remaining > 0) {
+        size_t bytes = std::min(remaining, SLOT_BYTES);
+        if (!take(out, bytes)) {
+            // Ring ran dry: serve the rest now rather than wait for the producer
+            miss_count.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(source_lock);
+            source.generateInto(out, remaining * 8);
+            break;
+        }
+        out += bytes;
+        remaining -= bytes;
+    }
+    wake_if_low();
+}
+
+void DRBGPrefetcher::reseed(const std::vector<uint8_t>& seed) {
+    {
+        std::lock_guard<std::mutex> guard(source_lock);
+        source.reseed(seed);
+        // The producer publishes under source_lock, so everything in the ring
+        // now predates the reseed
+        uint8_t discarded[SLOT_BYTES];
+        while (take(discarded, 0)) {
+        }
+    }
+    wake_if_low();
+}
+
+void DRBGPrefetcher::wake_if_low() {
+    if (sleeping.load() && available() <= low) {
+        std::lock_guard<std::mutex> guard(wake_lock);
+        wake.notify_one();
+    }
+}
+
+void DRBGPrefetcher::fill(uint8_t* batch, size_t count) {
+    std::lock_guard<std::mutex> guard(source_lock);
+    source.generateInto(batch, count * SLOT_BYTES * 8);
+
+    uint64_t pos = tail.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i, ++pos) {
+        Slot& slot = slots[pos & (capacity - 1)];
+        // A consumer may have claimed the slot's previous contents but not
+        // yet released it
+        while (slot.sequence.load(std::memory_order_acquire) != pos) {
+            std::this_thread::yield();
+        }
+        std::memcpy(slot.data, batch + i * SLOT_BYTES, SLOT_BYTES);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        tail.store(pos + 1, std::memory_order_release);
+    }
+    std::memset(batch, 0, count * SLOT_BYTES);
+}
+
+void DRBGPrefetcher::produce() {
+    std::vector<uint8_t> batch(BATCH_SLOTS * SLOT_BYTES);
+    while (!stopping.load()) {
+        size_t level = available();
+        if (level < high) {
+            fill(batch.data(), std::min(BATCH_SLOTS, high - level));
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(wake_lock);
+        // Set before re-reading the level, so a consumer that drains the ring
+        // after this point is sure to see it and notify
+        sleeping.store(true);
+        wake.wait(guard, [this] { return stopping.load() || available() <= low; });
+        sleeping.store(false);
+    }
+    secure_wipe(batch.data(), batch.size());
+}
@@ -0,0 +1,67 @@
+/**
+ * @file drbg_reader.cpp
+ * @brief Buffered typed-draw reader
+ */
+
+#include "drbg_reader.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // Zeroing through a volatile pointer cannot be dropped as a dead store,
+    // even right before the buffer is freed
+    void secure_wipe(uint8_t* data, size_t size) {
+        volatile uint8_t* p = data;
+        for (size_t i = 0; i < size; ++i) {
+            p[i] = 0;
+        }
+    }
+}
+
+DRBGReader::DRBGReader(DRBG& drbg, size_t buffer_bytes) : drbg(drbg) {
+    if (buffer_bytes == 0) {
+        throw std::invalid_argument("DRBGReader: buffer size must be positive");
+    }
+    buffer.resize((buffer_bytes + BUFFER_ALIGN - 1) / BUFFER_ALIGN * BUFFER_ALIGN);
+    position = buffer.size();
+}
+
+DRBGReader::~DRBGReader() {
+    secure_wipe(buffer.data(), buffer.size());
+}
+
+void DRBGReader::refill() {
+    // Unread bytes too short for the draw are overwritten, never served
+    drbg.generateInto(buffer.data(), buffer.size() * 8);
+    position = 0;
+}
+
+void DRBGReader::readBytes(uint8_t* out, size_t num_bytes) {
+    // Drain what is buffered first
+    size_t take = std::min(num_bytes, buffer.size() - position);
+    std::memcpy(out, buffer.data() + position, take);
+    std::memset(buffer.data() + position, 0, take);
+    position += take;
+    out += take;
+    num_bytes -= take;
+
+    // Full buffers skip the copy and go straight to the caller
+    size_t direct = num_bytes - num_bytes % buffer.size();
+    if (direct > 0) {
+        drbg.generateInto(out, direct * 8);
+        out += direct;
+        num_bytes -= direct;
+    }
+
+    if (num_bytes > 0) {
+        refill();
+        std::memcpy(out, buffer.data(), num_bytes);
+        std::memset(buffer.data(), 0, num_bytes);
+        position = num_bytes;
+    }
+}
+
+void DRBGReader::discard() {
+    secure_wipe(buffer.data(), buffer.size());
+    position = buffer.size();
+}
@@ -0,0 +1,51 @@
+/**
+ * @file locked_drbg.cpp
+ * @brief SpinLock contended path and thread hashing for ShardedDRBG
+ */
+
+#include "locked_drbg.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+}
+
+namespace locked_drbg_detail {
+    size_t thread_hash() {
+        static thread_local const size_t hash = [] {
+            // splitmix64 finalizer
+            uint64_t x = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return static_cast<size_t>(x ^ (x >> 31));
+        }();
+        return hash;
+    }
+}
+
+void SpinLock::lock_contended() {
+    static const bool single_cpu = std::thread::hardware_concurrency() <= 1;
+    int limit = single_cpu ? 0 : std::min(MAX_SPINS, 2 * spin_estimate.load(std::memory_order_relaxed) + 10);
+    int spins = 0;
+    do {
+        // Wait on a plain load, so waiters share the line instead of bouncing it
+        while (locked.load(std::memory_order_relaxed)) {
+            if (spins < limit) {
+                ++spins;
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    } while (locked.exchange(true, std::memory_order_acquire));
+
+    int estimate = spin_estimate.load(std::memory_order_relaxed);
+    spin_estimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+}
@@ -3,7 +3,7 @@
  * @brief Main program for DRBG benchmarking and comparison
  * 
  * This program implements and compares two Deterministic Random Bit Generators:
- * 1. CTR-DRBG (Counter mode DRBG)
+ * 1. CTR-DRBG (Counter mode DRBG), with the educational SPN and with AES-256
  * 2. Hash-DRBG (SHA-256 based)
  * 
  * Comparison metrics:
@@ -14,11 +14,21 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <random>
 #include <cmath>
+#include <thread>
+#include <type_traits>
 #include "drbg.hpp"
+#include "sha256.hpp"
+#include "aes256.hpp"
+#include "distributions.hpp"
+#include "sampling.hpp"
+#include "drbg_prefetcher.hpp"
+#include "cpu_features.hpp"
+#include "selftest.hpp"
 #include "benchmark.hpp"
 
 /**
@@ -58,6 +68,9 @@ void printDRBGInfo() {
     std::cout << "│                      DRBG Algorithms Implemented                        │\n";
     std::cout << "├─────────────────────────────────────────────────────────────────────────┤\n";
     std::cout << "│ 1. CTR-DRBG   : Counter mode DRBG based on AES-like block cipher       │\n";
+    std::cout << "│    CTR-DRBG-T : Same cipher, rounds merged into 32-bit T-tables        │\n";
+    std::cout << "│    CTR-DRBG-BS: Same cipher, bit-sliced AVX2, 32 blocks per batch      │\n";
+    std::cout << "│    AES-CTR-DRBG: NIST SP 800-90A, AES-256 with derivation function     │\n";
     std::cout << "│ 2. Hash-DRBG  : NIST SP 800-90A compliant, uses SHA-256                │\n";
     std::cout << "└─────────────────────────────────────────────────────────────────────────┘\n\n";
 }
@@ -75,7 +88,7 @@ void printProgress(const std::string& drbg_name, size_t bits, int current, int t
  * @brief Print a single benchmark result
  */
 void printResult(const BenchmarkResult& r) {
-    std::cout << "  │ " << std::setw(10) << r.drbg_name 
+    std::cout << "  │ " << std::setw(12) << r.drbg_name 
               << " │ " << std::setw(10) << r.num_bits
               << " │ " << std::setw(12) << std::fixed << std::setprecision(2) << r.generation_time_us
               << " │ " << std::setw(12) << r.count_zeros
@@ -84,7 +97,413 @@ void printResult(const BenchmarkResult& r) {
               << "% │\n";
 }
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+/**
+ * @brief Compare generate(bits) and generate<Bits>() on key- and nonce-sized requests
+ */
+void runSmallRequestSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t ITERATIONS = 200000;
+    
+    CTR_DRBG ctr(seed);
+    CTR_DRBG ctr_ttable(seed, CTR_DRBG::Cipher::TTable);
+    CTR_DRBG ctr_bitsliced(seed, CTR_DRBG::Cipher::Bitsliced);
+    AES_CTR_DRBG aes_ctr(seed);
+    Hash_DRBG hash(seed);
+    HMAC_DRBG hmac(seed);
+    
+    std::vector<SmallRequestResult> results;
+    auto run_sizes = [&results](auto& drbg) {
+        results.push_back(Benchmark::runSmallRequests<128>(drbg, ITERATIONS));
+        results.push_back(Benchmark::runSmallRequests<256>(drbg, ITERATIONS));
+    };
+    run_sizes(ctr);
+    run_sizes(ctr_ttable);
+    run_sizes(ctr_bitsliced);
+    run_sizes(aes_ctr);
+    run_sizes(hash);
+    run_sizes(hmac);
+    
+    std::cout << "┌──────────────┬────────┬──────────────┬──────────────┬──────────┐\n";
+    std::cout << "│     DRBG     │  Bits  │ vector (ns)  │ array (ns)   │ Speedup  │\n";
+    std::cout << "├──────────────┼────────┼──────────────┼──────────────┼──────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(6) << r.num_bits
+                  << " │ " << std::setw(12) << std::fixed << std::setprecision(1) << r.vector_ns
+                  << " │ " << std::setw(12) << r.array_ns
+                  << " │ " << std::setw(7) << std::setprecision(2) << r.vector_ns / r.array_ns
+                  << "x │\n";
+    }
+    std::cout << "└──────────────┴────────┴──────────────┴──────────────┴──────────┘\n\n";
+}
+
+/**
+ * @brief Compare one request per 64-bit draw with DRBGReader at several buffer sizes
+ */
+void runDrawSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t NUM_DRAWS = 200000;
+    const size_t buffer_sizes[] = {0, 256, DRBGReader::DEFAULT_BUFFER_BYTES, 65536};
+    
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::Bitsliced));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    drbgs.push_back(std::make_unique<HMAC_DRBG>(seed));
+    
+    std::cout << "┌──────────────┬──────────┬──────────────┬──────────┐\n";
+    std::cout << "│     DRBG     │  Buffer  │  Mdraws/s    │ Speedup  │\n";
+    std::cout << "├──────────────┼──────────┼──────────────┼──────────┤\n";
+    for (const auto& drbg : drbgs) {
+        double unbuffered = 0;
+        for (size_t buffer_bytes : buffer_sizes) {
+            DrawResult r = Benchmark::runDraws(*drbg, buffer_bytes, NUM_DRAWS);
+            if (buffer_bytes == 0) {
+                unbuffered = r.draws_per_second;
+            }
+            std::cout << "│ " << std::setw(12) << r.drbg_name
+                      << " │ " << std::setw(8) << (r.buffer_bytes ? std::to_string(r.buffer_bytes) : "none")
+                      << " │ " << std::setw(12) << std::fixed << std::setprecision(3) << r.draws_per_second / 1e6
+                      << " │ " << std::setw(7) << std::setprecision(1) << r.draws_per_second / unbuffered
+                      << "x │\n";
+        }
+    }
+    std::cout << "└──────────────┴──────────┴──────────────┴──────────┘\n\n";
+}
+
+/**
+ * @brief Compare std::uniform_int_distribution with Uniform::below and fillBelow
+ */
+void runUniformSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t COUNT = 1000000;
+    // A die, a typical index, and 2^31 + 1 where half of all words are rejected
+    const uint32_t bounds[] = {6, 1000, 0x80000001u};
+    
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    
+    std::cout << "┌──────────────┬────────────┬──────────────┬──────────────┬──────────────┐\n";
+    std::cout << "│     DRBG     │     n      │ std (M/s)    │ below (M/s)  │ fill (M/s)   │\n";
+    std::cout << "├──────────────┼────────────┼──────────────┼──────────────┼──────────────┤\n";
+    for (const auto& drbg : drbgs) {
+        for (uint32_t bound : bounds) {
+            UniformResult r = Benchmark::runUniform(*drbg, bound, COUNT);
+            std::cout << "│ " << std::setw(12) << r.drbg_name
+                      << " │ " << std::setw(10) << r.bound
+                      << " │ " << std::setw(12) << std::fixed << std::setprecision(2) << r.std_mvalues_per_second
+                      << " │ " << std::setw(12) << r.below_mvalues_per_second
+                      << " │ " << std::setw(12) << r.fill_mvalues_per_second
+                      << " │\n";
+        }
+    }
+    std::cout << "└──────────────┴────────────┴──────────────┴──────────────┴──────────────┘\n\n";
+}
+
+/**
+ * @brief Compare <random> real distributions with the bulk unit-interval and ziggurat fills
+ */
+void runRealSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t COUNT = 1000000;
+    
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::Bitsliced));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    drbgs.push_back(std::make_unique<HMAC_DRBG>(seed));
+    
+    std::cout << "Million values per second\n";
+    std::cout << "┌──────────────┬──────────┬──────────┬──────────┬──────────┬──────────┐\n";
+    std::cout << "│     DRBG     │ std unif │ doubles  │  floats  │ std norm │ ziggurat │\n";
+    std::cout << "├──────────────┼──────────┼──────────┼──────────┼──────────┼──────────┤\n";
+    for (const auto& drbg : drbgs) {
+        RealResult r = Benchmark::runReals(*drbg, COUNT);
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(8) << std::fixed << std::setprecision(2) << r.std_uniform_mvalues_per_second
+                  << " │ " << std::setw(8) << r.doubles_mvalues_per_second
+                  << " │ " << std::setw(8) << r.floats_mvalues_per_second
+                  << " │ " << std::setw(8) << r.std_normal_mvalues_per_second
+                  << " │ " << std::setw(8) << r.normal_mvalues_per_second
+                  << " │\n";
+    }
+    std::cout << "└──────────────┴──────────┴──────────┴──────────┴──────────┴──────────┘\n\n";
+}
+
+/**
+ * @brief Compare std::shuffle with Sampling::shuffle and time reservoir sampling, 10^3 to 10^8 elements
+ */
+void runShuffleSuite(const std::vector<uint8_t>& seed) {
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    
+    std::cout << "Million elements per second (uint32_t arrays)\n";
+    std::cout << "┌──────────────┬────────────┬──────────────┬──────────────┬──────────────┐\n";
+    std::cout << "│     DRBG     │  Elements  │ std::shuffle │   shuffle    │  reservoir   │\n";
+    std::cout << "├──────────────┼────────────┼──────────────┼──────────────┼──────────────┤\n";
+    for (const auto& drbg : drbgs) {
+        for (size_t n = 1000; n <= 100000000; n *= 10) {
+            ShuffleResult r = Benchmark::runShuffle(*drbg, n);
+            std::cout << "│ " << std::setw(12) << r.drbg_name
+                      << " │ " << std::setw(10) << r.num_elements
+                      << " │ " << std::setw(12) << std::fixed << std::setprecision(2) << r.std_shuffle_melements_per_second
+                      << " │ " << std::setw(12) << r.shuffle_melements_per_second
+                      << " │ " << std::setw(12) << r.reservoir_melements_per_second
+                      << " │\n";
+        }
+    }
+    std::cout << "└──────────────┴────────────┴──────────────┴──────────────┴──────────────┘\n\n";
+}
+
+/**
+ * @brief Scale 256-bit requests from 1 to 32 threads: one locked instance vs DRBGPool
+ */
+void runPoolSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t TOTAL_REQUESTS = 100000;
+    const size_t thread_counts[] = {1, 2, 4, 8, 16, 32};
+    
+    std::vector<PoolScalingResult> results;
+    for (size_t threads : thread_counts) {
+        results.push_back(Benchmark::runPoolScaling<CTR_DRBG>(seed,
+            [](const std::vector<uint8_t>& s) { return CTR_DRBG(s, CTR_DRBG::Cipher::TTable); },
+            threads, TOTAL_REQUESTS));
+    }
+    for (size_t threads : thread_counts) {
+        results.push_back(Benchmark::runPoolScaling<AES_CTR_DRBG>(seed,
+            [](const std::vector<uint8_t>& s) { return AES_CTR_DRBG(s); }, threads, TOTAL_REQUESTS));
+    }
+    for (size_t threads : thread_counts) {
+        results.push_back(Benchmark::runPoolScaling<Hash_DRBG>(seed,
+            [](const std::vector<uint8_t>& s) { return Hash_DRBG(s); }, threads, TOTAL_REQUESTS));
+    }
+    for (size_t threads : thread_counts) {
+        results.push_back(Benchmark::runPoolScaling<HMAC_DRBG>(seed,
+            [](const std::vector<uint8_t>& s) { return HMAC_DRBG(s); }, threads, TOTAL_REQUESTS));
+    }
+    
+    std::cout << "Million 256-bit requests per second, all threads combined\n";
+    std::cout << "┌──────────────┬─────────┬──────────────┬──────────────┬──────────────┐\n";
+    std::cout << "│     DRBG     │ Threads │   mutex      │  per-thread  │   per-core   │\n";
+    std::cout << "├──────────────┼─────────┼──────────────┼──────────────┼──────────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(7) << r.num_threads
+                  << " │ " << std::setw(12) << std::fixed << std::setprecision(3) << r.locked_mrequests_per_second
+                  << " │ " << std::setw(12) << r.per_thread_mrequests_per_second
+                  << " │ " << std::setw(12) << r.per_core_mrequests_per_second
+                  << " │\n";
+    }
+    std::cout << "└──────────────┴─────────┴──────────────┴──────────────┴──────────────┘\n\n";
+}
+
+/**
+ * @brief Compare mutex-wrapped CTR generators with SharedCTR_DRBG at 1-64 threads
+ */
+void runSharedCounterSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t TOTAL_REQUESTS = 200000;
+    const size_t thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+    
+    std::vector<SharedCounterResult> results;
+    for (size_t threads : thread_counts) {
+        results.push_back(Benchmark::runSharedCounter(seed, threads, TOTAL_REQUESTS));
+    }
+    
+    std::cout << "Million 256-bit requests per second, all threads combined\n";
+    std::cout << "┌─────────┬──────────────┬──────────────┬──────────────┐\n";
+    std::cout << "│ Threads │ CTR-DRBG-T   │ AES-CTR-DRBG │ Shared AES   │\n";
+    std::cout << "│         │ + mutex      │ + mutex      │ (lock-free)  │\n";
+    std::cout << "├─────────┼──────────────┼──────────────┼──────────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(7) << r.num_threads
+                  << " │ " << std::setw(12) << std::fixed << std::setprecision(3) << r.locked_ctr_mrequests_per_second
+                  << " │ " << std::setw(12) << r.locked_aes_mrequests_per_second
+                  << " │ " << std::setw(12) << r.shared_mrequests_per_second
+                  << " │\n";
+    }
+    std::cout << "└─────────┴──────────────┴──────────────┴──────────────┘\n\n";
+}
+
+/**
+ * @brief Sweep threads and request sizes over mutex, spinlock and sharded wrappers
+ */
+void runContentionSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t BYTES_PER_RUN = 4 * 1024 * 1024;
+    const size_t thread_counts[] = {1, 4, 16, 64};
+    const size_t request_bits[] = {256, 4096, 65536};
+    
+    std::vector<ContentionResult> results;
+    auto sweep = [&](auto tag) {
+        using D = typename decltype(tag)::type;
+        for (size_t bits : request_bits) {
+            size_t requests = std::clamp<size_t>(BYTES_PER_RUN / (bits / 8), 2000, 40000);
+            for (size_t threads : thread_counts) {
+                auto runs = Benchmark::runContention<D>(seed, threads, bits, requests);
+                results.insert(results.end(), runs.begin(), runs.end());
+            }
+        }
+    };
+    sweep(std::type_identity<Hash_DRBG>{});
+    sweep(std::type_identity<HMAC_DRBG>{});
+    
+    std::cout << "┌──────────────┬──────────┬─────────┬────────┬────────────┬────────────┬────────────┐\n";
+    std::cout << "│     DRBG     │ Strategy │ Threads │  Bits  │   MB/s     │ p50 (us)   │ p99 (us)   │\n";
+    std::cout << "├──────────────┼──────────┼─────────┼────────┼────────────┼────────────┼────────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(8) << r.strategy
+                  << " │ " << std::setw(7) << r.num_threads
+                  << " │ " << std::setw(6) << r.num_bits
+                  << " │ " << std::setw(10) << std::fixed << std::setprecision(2) << r.mbytes_per_second
+                  << " │ " << std::setw(10) << r.p50_us
+                  << " │ " << std::setw(10) << r.p99_us
+                  << " │\n";
+    }
+    std::cout << "└──────────────┴──────────┴─────────┴────────┴────────────┴────────────┴────────────┘\n\n";
+}
+
+/**
+ * @brief Compare per-request latency of direct calls and DRBGPrefetcher
+ */
+void runPrefetchSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t NUM_REQUESTS = 20000;
+    
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    drbgs.push_back(std::make_unique<HMAC_DRBG>(seed));
+    
+    std::vector<PrefetchLatencyResult> results;
+    for (const auto& drbg : drbgs) {
+        for (size_t bits : {128, 256}) {
+            results.push_back(Benchmark::runPrefetchLatency(*drbg, bits, NUM_REQUESTS));
+        }
+    }
+    
+    std::cout << "┌──────────────┬────────┬────────────┬────────────┬────────────┬────────────┬────────┐\n";
+    std::cout << "│     DRBG     │  Bits  │ direct p50 │ direct p99 │ ring p50   │ ring p99   │ Miss % │\n";
+    std::cout << "├──────────────┼────────┼────────────┼────────────┼────────────┼────────────┼────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(6) << r.num_bits
+                  << " │ " << std::setw(10) << std::fixed << std::setprecision(1) << r.direct_p50_ns
+                  << " │ " << std::setw(10) << r.direct_p99_ns
+                  << " │ " << std::setw(10) << r.prefetch_p50_ns
+                  << " │ " << std::setw(10) << r.prefetch_p99_ns
+                  << " │ " << std::setw(6) << std::setprecision(2) << r.miss_percent
+                  << " │\n";
+    }
+    std::cout << "└──────────────┴────────┴────────────┴────────────┴────────────┴────────────┴────────┘\n\n";
+}
+
+/**
+ * @brief Compare event-loop tick lateness under blocking and awaited bulk requests
+ */
+void runAsyncSuite(const std::vector<uint8_t>& seed) {
+    constexpr size_t REQUEST_BITS = 10000000;
+    constexpr size_t NUM_REQUESTS = 8;
+    
+    std::vector<std::unique_ptr<DRBG>> drbgs;
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
+    drbgs.push_back(std::make_unique<HMAC_DRBG>(seed));
+    
+    WorkerPool pool;
+    std::vector<LoopResponsivenessResult> results;
+    for (const auto& drbg : drbgs) {
+        results.push_back(Benchmark::runLoopResponsiveness(*drbg, pool, REQUEST_BITS, NUM_REQUESTS));
+    }
+    
+    std::cout << NUM_REQUESTS << " x " << REQUEST_BITS << "-bit requests from the loop, "
+              << pool.threadCount() << " worker thread(s); tick lateness in us\n";
+    std::cout << "┌──────────────┬────────────┬────────────┬────────────┬────────────┬────────────┬────────────┐\n";
+    std::cout << "│              │         blocking on the loop         │        co_await asyncGenerate        │\n";
+    std::cout << "│     DRBG     │ total (ms) │ tick p99   │ tick max   │ total (ms) │ tick p99   │ tick max   │\n";
+    std::cout << "├──────────────┼────────────┼────────────┼────────────┼────────────┼────────────┼────────────┤\n";
+    for (const auto& r : results) {
+        std::cout << "│ " << std::setw(12) << r.drbg_name
+                  << " │ " << std::setw(10) << std::fixed << std::setprecision(1) << r.blocking_ms
+                  << " │ " << std::setw(10) << r.blocking_p99_us
+                  << " │ " << std::setw(10) << r.blocking_max_us
+                  << " │ " << std::setw(10) << r.async_ms
+                  << " │ " << std::setw(10) << r.async_p99_us
+                  << " │ " << std::setw(10) << r.async_max_us
+                  << " │\n";
+    }
+    std::cout << "└──────────────┴────────────┴────────────┴────────────┴────────────┴────────────┴────────────┘\n\n";
+}
+
+/**
+ * @brief Run every fast-path-vs-reference check and print the outcome
+ * @return true if all of them passed
+ */
+bool runSelfTestSuite() {
+    bool all_passed = true;
+    std::cout << "┌──────────────────────────────────────┬────────┐\n";
+    std::cout << "│ Check                                │ Result │\n";
+    std::cout << "├──────────────────────────────────────┼────────┤\n";
+    for (const auto& r : SelfTest::runAll()) {
+        all_passed = all_passed && r.passed;
+        std::cout << "│ " << std::left << std::setw(36) << r.name << std::right
+                  << " │ " << (r.passed ? "  ok  " : " FAIL ") << " │\n";
+    }
+    std::cout << "└──────────────────────────────────────┴────────┘\n\n";
+    return all_passed;
+}
+
+int main(int argc, char* argv[]) {
+    // --threads N: worker threads for CTR-DRBG and Hash-DRBG bulk generation
+    // (0 = all cores); --small / --draws / --uniform / --reals / --shuffle /
+    // --pool / --shared / --contention / --prefetch / --async: run the
+    // small-request, buffered-draw, bounded-integer, real-valued, shuffle,
+    // thread-scaling, shared-counter, lock-contention, prefetch latency or
+    // event-loop responsiveness suite instead; --selftest: compare every
+    // accelerated kernel with its reference and exit non-zero on a mismatch
+    size_t bulk_threads = 1;
+    bool small_requests = false;
+    bool draws = false;
+    bool uniform = false;
+    bool reals = false;
+    bool shuffle = false;
+    bool pool = false;
+    bool shared = false;
+    bool contention = false;
+    bool prefetch = false;
+    bool async = false;
+    bool selftest = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            bulk_threads = std::stoul(argv[++i]);
+        } else if (arg == "--small") {
+            small_requests = true;
+        } else if (arg == "--draws") {
+            draws = true;
+        } else if (arg == "--uniform") {
+            uniform = true;
+        } else if (arg == "--reals") {
+            reals = true;
+        } else if (arg == "--shuffle") {
+            shuffle = true;
+        } else if (arg == "--pool") {
+            pool = true;
+        } else if (arg == "--shared") {
+            shared = true;
+        } else if (arg == "--contention") {
+            contention = true;
+        } else if (arg == "--prefetch") {
+            prefetch = true;
+        } else if (arg == "--async") {
+            async = true;
+        } else if (arg == "--selftest") {
+            selftest = true;
+        }
+    }
+    
     printHeader();
     printDRBGInfo();
     
@@ -93,11 +512,98 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     
     std::cout << "📋 Seed generated: " << seed.size() << " bytes from system entropy\n\n";
     
+    if (selftest) {
+        std::cout << "🧪 Self-test: accelerated kernels vs reference (SHA-256 kernel: "
+                  << SHA256::kernelName() << ")\n";
+        return runSelfTestSuite() ? 0 : 1;
+    }
+    
+    if (small_requests) {
+        std::cout << "🔑 Small requests: generate(bits) vs generate<Bits>()\n";
+        runSmallRequestSuite(seed);
+        return 0;
+    }
+    
+    if (draws) {
+        std::cout << "🎲 64-bit draws: generateInto() per draw vs DRBGReader\n";
+        runDrawSuite(seed);
+        return 0;
+    }
+    
+    if (uniform) {
+        std::cout << "🎯 Bounded integers in [0, n), kernel: " << Uniform::kernelName() << "\n";
+        runUniformSuite(seed);
+        return 0;
+    }
+    
+    if (reals) {
+        std::cout << "📈 Uniform and normal reals, kernel: " << Uniform::kernelName() << "\n";
+        runRealSuite(seed);
+        return 0;
+    }
+    
+    if (shuffle) {
+        std::cout << "🃏 Shuffle and reservoir sampling, blocked shuffle above "
+                  << Sampling::blockedShuffleThreshold() / (1024 * 1024) << " MiB (LLC: "
+                  << CpuFeatures::get().llc_bytes / (1024 * 1024) << " MiB)\n";
+        runShuffleSuite(seed);
+        return 0;
+    }
+    
+    if (pool) {
+        std::cout << "🧵 Thread scaling: shared locked DRBG vs DRBGPool ("
+                  << std::thread::hardware_concurrency() << " hardware threads)\n";
+        runPoolSuite(seed);
+        return 0;
+    }
+    
+    if (shared) {
+        std::cout << "🔢 Shared CTR: mutex-wrapped DRBGs vs SharedCTR_DRBG counter reservation (AES kernel: "
+                  << AES256::kernelName() << ")\n";
+        runSharedCounterSuite(seed);
+        return 0;
+    }
+    
+    if (contention) {
+        std::cout << "🔒 Lock contention: mutex vs adaptive spinlock vs sharded ("
+                  << std::thread::hardware_concurrency() << " hardware threads)\n";
+        runContentionSuite(seed);
+        return 0;
+    }
+    
+    if (prefetch) {
+        std::cout << "⏱️  Request latency (ns): direct vs DRBGPrefetcher ring ("
+                  << DRBGPrefetcher::DEFAULT_SLOTS << " x " << DRBGPrefetcher::SLOT_BYTES
+                  << "-byte slots)\n";
+        runPrefetchSuite(seed);
+        return 0;
+    }
+    
+    if (async) {
+        std::cout << "🔁 Event-loop responsiveness: blocking generate vs AsyncDRBG ("
+                  << AsyncDRBG::CHUNK_BYTES / 1024 << " KiB chunks)\n";
+        runAsyncSuite(seed);
+        return 0;
+    }
+    
     // Create DRBG instances
     std::vector<std::unique_ptr<DRBG>> drbgs;
     drbgs.push_back(std::make_unique<CTR_DRBG>(seed));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::TTable));
+    drbgs.push_back(std::make_unique<CTR_DRBG>(seed, CTR_DRBG::Cipher::Bitsliced));
+    drbgs.push_back(std::make_unique<AES_CTR_DRBG>(seed));
     drbgs.push_back(std::make_unique<Hash_DRBG>(seed));
     
+    for (const auto& drbg : drbgs) {
+        if (auto* ctr = dynamic_cast<CTR_DRBG*>(drbg.get())) {
+            ctr->setThreadCount(bulk_threads);
+            bulk_threads = ctr->getThreadCount();
+        } else if (auto* hash = dynamic_cast<Hash_DRBG*>(drbg.get())) {
+            hash->setThreadCount(bulk_threads);
+            bulk_threads = hash->getThreadCount();
+        }
+    }
+    
     // Print state sizes
     std::cout << "💾 Internal State Sizes:\n";
     for (const auto& drbg : drbgs) {
@@ -106,6 +612,10 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     }
     std::cout << "\n";
     
+    std::cout << "⚙️  SHA-256 kernel: " << SHA256::kernelName() << "\n";
+    std::cout << "⚙️  AES-256 kernel: " << AES256::kernelName() << "\n";
+    std::cout << "🧵 Bulk generation threads: " << bulk_threads << "\n\n";
+    
     // Define test sequence lengths: 10^1 to 10^7
     std::vector<size_t> bit_lengths = {
         10,          // 10^1
@@ -140,17 +650,17 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     std::cout << "\n\n✅ Benchmarks completed!\n\n";
     
     // Print results table
-    std::cout << "┌────────────────────────────────────────────────────────────────────────────────────┐\n";
-    std::cout << "│                              BENCHMARK RESULTS                                     │\n";
-    std::cout << "├────────────┬────────────┬──────────────┬──────────────┬──────────────┬────────────┤\n";
-    std::cout << "│    DRBG    │    Bits    │   Time (μs)  │    Zeros     │    Ones      │   Bias     │\n";
-    std::cout << "├────────────┼────────────┼──────────────┼──────────────┼──────────────┼────────────┤\n";
+    std::cout << "┌──────────────────────────────────────────────────────────────────────────────────────┐\n";
+    std::cout << "│                               BENCHMARK RESULTS                                      │\n";
+    std::cout << "├──────────────┬────────────┬──────────────┬──────────────┬──────────────┬────────────┤\n";
+    std::cout << "│     DRBG     │    Bits    │   Time (μs)  │    Zeros     │    Ones      │   Bias     │\n";
+    std::cout << "├──────────────┼────────────┼──────────────┼──────────────┼──────────────┼────────────┤\n";
     
     for (const auto& r : all_results) {
         printResult(r);
     }
     
-    std::cout << "└────────────┴────────────┴──────────────┴──────────────┴──────────────┴────────────┘\n\n";
+    std::cout << "└──────────────┴────────────┴──────────────┴──────────────┴──────────────┴────────────┘\n\n";
     
     // Export results
     std::cout << "📁 Exporting results...\n";
@@ -176,6 +686,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
         double total_time = 0;
         double total_bias = 0;
         double max_throughput = 0;
+        double max_throughput_into = 0;
         int count = 0;
         
         for (const auto& r : all_results) {
@@ -183,6 +694,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
                 total_time += r.generation_time_us;
                 total_bias += r.bias;
                 max_throughput = std::max(max_throughput, r.bits_per_microsecond);
+                max_throughput_into = std::max(max_throughput_into, r.bits_per_microsecond_into);
                 count++;
             }
         }
@@ -193,7 +705,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
         std::cout << "   • Avg Bias:        " << std::setprecision(6) 
                   << (total_bias / count) * 100 << " %\n";
         std::cout << "   • Max Throughput:  " << std::setprecision(2) 
-                  << max_throughput << " bits/μs\n\n";
+                  << max_throughput << " bits/μs\n";
+        std::cout << "   • generateInto:    " << max_throughput_into << " bits/μs\n\n";
     }
     
     std::cout << "═══════════════════════════════════════════════════════════════════════════\n";
@@ -0,0 +1,89 @@
+/**
+ * @file sampling.cpp
+ * @brief Batched Fisher-Yates swap targets and block ids
+ */
+
+#include "sampling.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr size_t DEFAULT_LLC_BYTES = 32 * 1024 * 1024;
+
+    // Uniform in [0, bound] from one 64-bit word (bound + 1 may be 2^64)
+    uint64_t target_wide(DRBGReader& rng, uint64_t bound) {
+        if (bound == ~uint64_t{0}) {
+            return rng.nextUint64();
+        }
+        return Uniform::below64(rng, bound + 1);
+    }
+}
+
+void Sampling::swapTargets(DRBGReader& rng, uint64_t top, size_t count, uint64_t* out) {
+    size_t s = 0;
+
+    // One word per step until (top - s + 1) * (top - s) fits in 64 bits
+    for (; s < count && top - s > 0xFFFFFFFFull; ++s) {
+        out[s] = target_wide(rng, top - s);
+    }
+
+    for (; s + 1 < count; s += 2) {
+        uint64_t b1 = top - s + 1;
+        uint64_t b2 = top - s;
+        uint64_t product = b1 * b2;
+
+        unsigned __int128 m1 = static_cast<unsigned __int128>(rng.nextUint64()) * b1;
+        unsigned __int128 m2 = static_cast<unsigned __int128>(static_cast<uint64_t>(m1)) * b2;
+        if (static_cast<uint64_t>(m2) < product) {
+            uint64_t threshold = (0 - product) % product;
+            while (static_cast<uint64_t>(m2) < threshold) {
+                m1 = static_cast<unsigned __int128>(rng.nextUint64()) * b1;
+                m2 = static_cast<unsigned __int128>(static_cast<uint64_t>(m1)) * b2;
+            }
+        }
+        out[s] = static_cast<uint64_t>(m1 >> 64);
+        out[s + 1] = static_cast<uint64_t>(m2 >> 64);
+    }
+
+    if (s < count) {
+        out[s] = target_wide(rng, top - s);
+    }
+}
+
+void Sampling::fillBlockIds(DRBGReader& rng, uint32_t num_blocks, uint16_t* out, size_t count) {
+    if (num_blocks == 1) {
+        std::fill(out, out + count, 0);
+        return;
+    }
+    size_t per_word = 1;
+    uint64_t product = num_blocks;
+    while (product <= (uint64_t{1} << 56) / num_blocks) {
+        product *= num_blocks;
+        ++per_word;
+    }
+    uint64_t threshold = (0 - product) % product;
+
+    uint16_t tail[64];
+    for (size_t i = 0; i < count; i += per_word) {
+        // Full batches decode straight into out; only a partial last one
+        // goes through the scratch array
+        uint16_t* ids = (count - i >= per_word) ? out + i : tail;
+        uint64_t rest;
+        do {
+            rest = rng.nextUint64();
+            for (size_t j = 0; j < per_word; ++j) {
+                unsigned __int128 m = static_cast<unsigned __int128>(rest) * num_blocks;
+                ids[j] = static_cast<uint16_t>(m >> 64);
+                rest = static_cast<uint64_t>(m);
+            }
+        } while (rest < threshold);
+        if (ids == tail) {
+            std::copy(tail, tail + (count - i), out + i);
+        }
+    }
+}
+
+size_t Sampling::blockedShuffleThreshold() {
+    size_t llc = CpuFeatures::get().llc_bytes;
+    return (llc > 0) ? llc : DEFAULT_LLC_BYTES;
+}
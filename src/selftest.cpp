@@ -0,0 +1,231 @@
+/**
+ * @file selftest.cpp
+ * @brief Fast-path-vs-reference comparisons behind --selftest
+ */
+
+#include "selftest.hpp"
+#include "drbg.hpp"
+#include "sha256.hpp"
+#include "aes256.hpp"
+
+namespace {
+    // Request sizes in bytes: single bytes, partial and whole blocks, the
+    // remainders of interleaved and bit-sliced batches, and requests large
+    // enough to be split across four threads
+    const size_t REQUEST_BYTES[] = {1, 15, 16, 17, 63, 64, 65, 100, 511, 512, 513, 4000, 70000,
+                                    (1 << 20) + 5};
+
+    // Worker count for the threaded comparisons, whatever the core count
+    constexpr size_t THREADS = 4;
+
+    std::vector<uint8_t> pattern(size_t size, uint8_t salt) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 131 + salt);
+        }
+        return bytes;
+    }
+
+    // Same requests and reseeds on both; true if every output matches
+    bool same_output(DRBG& reference, DRBG& candidate) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t bytes : REQUEST_BYTES) {
+                if (reference.generate(bytes * 8) != candidate.generate(bytes * 8)) {
+                    return false;
+                }
+            }
+            auto seed = pattern(48, 0x5a);
+            reference.reseed(seed);
+            candidate.reseed(seed);
+        }
+        return true;
+    }
+
+    /**
+     * Hash_DRBG (SP 800-90A 10.1.1) written straight from the specification
+     * on the constexpr SHA-256: one block per hash, byte-wise arithmetic on V,
+     * none of the dispatched kernels, threading or limb tricks. Seeds must
+     * be SEED_BYTES long.
+     */
+    class HashDRBGModel : public DRBG {
+    public:
+        static constexpr size_t SEED_BYTES = 48;
+
+        explicit HashDRBGModel(const std::vector<uint8_t>& seed) {
+            std::array<uint8_t, SEED_BYTES> material;
+            std::copy(seed.begin(), seed.end(), material.begin());
+            derive(material);
+        }
+
+        void generateInto(uint8_t* out, size_t num_bits) override {
+            size_t num_bytes = (num_bits + 7) / 8;
+            Seed data = V;
+            for (size_t offset = 0; offset < num_bytes; offset += SHA256::DIGEST_SIZE) {
+                auto w = SHA256::hashConst(data);
+                std::copy(w.begin(), w.begin() + std::min(SHA256::DIGEST_SIZE, num_bytes - offset), out + offset);
+                const uint8_t one = 1;
+                add(data, &one, 1);
+            }
+
+            // V = V + Hash(0x03 || V) + C + reseed_counter
+            std::array<uint8_t, 1 + SEEDLEN> h_input = {0x03};
+            std::copy(V.begin(), V.end(), h_input.begin() + 1);
+            auto H = SHA256::hashConst(h_input);
+            add(V, H.data(), H.size());
+            add(V, C.data(), C.size());
+            uint8_t counter_be[8];
+            for (int i = 0; i < 8; ++i) {
+                counter_be[i] = static_cast<uint8_t>(reseed_counter >> (8 * (7 - i)));
+            }
+            add(V, counter_be, sizeof(counter_be));
+            reseed_counter++;
+        }
+
+        void reseed(const std::vector<uint8_t>& seed) override {
+            // seed_material = 0x01 || V || entropy_input
+            std::array<uint8_t, 1 + SEEDLEN + SEED_BYTES> material = {0x01};
+            std::copy(V.begin(), V.end(), material.begin() + 1);
+            std::copy(seed.begin(), seed.end(), material.begin() + 1 + SEEDLEN);
+            derive(material);
+        }
+
+        std::string getName() const override { return "Hash-DRBG model"; }
+        size_t getStateSize() const override { return 2 * SEEDLEN + sizeof(reseed_counter); }
+
+    private:
+        static constexpr size_t SEEDLEN = 55;
+        using Seed = std::array<uint8_t, SEEDLEN>;
+
+        Seed V;
+        Seed C;
+        uint64_t reseed_counter;
+
+        template <size_t N>
+        void derive(const std::array<uint8_t, N>& seed_material) {
+            V = Hash_DRBG::hashDfConst<SEEDLEN>(seed_material);
+            std::array<uint8_t, 1 + SEEDLEN> c_input = {0x00};
+            std::copy(V.begin(), V.end(), c_input.begin() + 1);
+            C = Hash_DRBG::hashDfConst<SEEDLEN>(c_input);
+            reseed_counter = 1;
+        }
+
+        // x = (x + y) mod 2^seedlen, with y big-endian and len <= SEEDLEN
+        static void add(Seed& x, const uint8_t* y, size_t len) {
+            unsigned carry = 0;
+            for (size_t i = 0; i < SEEDLEN; ++i) {
+                carry += x[SEEDLEN - 1 - i] + (i < len ? y[len - 1 - i] : 0u);
+                x[SEEDLEN - 1 - i] = static_cast<uint8_t>(carry);
+                carry >>= 8;
+            }
+        }
+    };
+
+    bool spn_kernel(CTR_DRBG::Cipher cipher, size_t threads) {
+        auto seed = pattern(48, 0x11);
+        CTR_DRBG reference(seed, CTR_DRBG::Cipher::Reference);
+        CTR_DRBG candidate(seed, cipher);
+        candidate.setThreadCount(threads);
+        return same_output(reference, candidate);
+    }
+
+    bool hash_drbg(size_t threads) {
+        auto seed = pattern(HashDRBGModel::SEED_BYTES, 0x11);
+        HashDRBGModel reference(seed);
+        Hash_DRBG candidate(seed);
+        candidate.setThreadCount(threads);
+        return same_output(reference, candidate);
+    }
+
+    // Streaming hashDf() against the constexpr hashDfConst(), evaluated at
+    // runtime on an N-byte input
+    template <size_t N>
+    bool hash_df_input() {
+        std::array<uint8_t, N> input;
+        auto bytes = pattern(N, 0x23);
+        std::copy(bytes.begin(), bytes.end(), input.begin());
+
+        auto seedlen = Hash_DRBG::hashDfConst<55>(input);
+        auto longer = Hash_DRBG::hashDfConst<100>(input);
+        return Hash_DRBG::hashDf(bytes, 55 * 8) == std::vector<uint8_t>(seedlen.begin(), seedlen.end()) &&
+               Hash_DRBG::hashDf(bytes, 100 * 8) == std::vector<uint8_t>(longer.begin(), longer.end());
+    }
+
+    bool hash_df() {
+        // Inputs that end before, at and past SHA-256 block boundaries
+        return hash_df_input<1>() && hash_df_input<55>() && hash_df_input<59>() &&
+               hash_df_input<64>() && hash_df_input<119>() && hash_df_input<200>();
+    }
+
+    // Dispatched compress() against the constexpr rounds over several blocks
+    bool sha256_compress() {
+        constexpr size_t BLOCKS = 9;
+        auto message = pattern(BLOCKS * SHA256::BLOCK_SIZE, 0x31);
+        SHA256::State expected = SHA256::INITIAL_STATE;
+        SHA256::State actual = SHA256::INITIAL_STATE;
+        for (size_t b = 0; b < BLOCKS; ++b) {
+            sha256_detail::compress_block(expected.data(), &message[b * SHA256::BLOCK_SIZE]);
+        }
+        SHA256::compress(actual.data(), message.data(), BLOCKS);
+        return expected == actual;
+    }
+
+    bool sha256_lanes() {
+        // One full 8-lane group plus a tail that falls back to compress()
+        constexpr size_t LANES = 11;
+        auto blocks = pattern(LANES * SHA256::BLOCK_SIZE, 0x47);
+        std::array<SHA256::State, LANES> expected;
+        std::array<SHA256::State, LANES> actual;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            expected[lane] = SHA256::INITIAL_STATE;
+            expected[lane][0] += static_cast<uint32_t>(lane);
+            actual[lane] = expected[lane];
+            sha256_detail::compress_block(expected[lane].data(), &blocks[lane * SHA256::BLOCK_SIZE]);
+        }
+        SHA256::compressLanes(actual.data(), blocks.data(), LANES);
+        return expected == actual;
+    }
+
+    // Dispatched ctrKeystream() against encryptBlock() on incremented counters
+    bool aes_keystream() {
+        // Several 8-block groups, a tail, and a carry across counter bytes
+        constexpr size_t BLOCKS = 37;
+        AES256::Key key;
+        auto key_bytes = pattern(AES256::KEY_SIZE, 0x05);
+        std::copy(key_bytes.begin(), key_bytes.end(), key.begin());
+        const AES256::RoundKeys rk = AES256::expandKey(key);
+
+        AES256::Block counter;
+        counter.fill(0xff);
+        counter[AES256::BLOCK_SIZE - 1] = 0xf0;
+        AES256::Block ctr = counter;
+        std::vector<uint8_t> actual(BLOCKS * AES256::BLOCK_SIZE);
+        AES256::ctrKeystream(rk, ctr.data(), actual.data(), BLOCKS);
+
+        for (size_t b = 0; b < BLOCKS; ++b) {
+            for (int i = AES256::BLOCK_SIZE - 1; i >= 0; --i) {
+                if (++counter[i] != 0) break;
+            }
+            AES256::Block expected = AES256::encryptBlock(rk, counter);
+            if (!std::equal(expected.begin(), expected.end(), actual.begin() + b * AES256::BLOCK_SIZE)) {
+                return false;
+            }
+        }
+        return ctr == counter;
+    }
+}
+
+std::vector<SelfTestResult> SelfTest::runAll() {
+    return {
+        {"SHA-256 compress (" + SHA256::kernelName() + ")", sha256_compress()},
+        {"SHA-256 multi-buffer lanes", sha256_lanes()},
+        {"AES-256 CTR keystream (" + AES256::kernelName() + ")", aes_keystream()},
+        {"SPN T-table kernel", spn_kernel(CTR_DRBG::Cipher::TTable, 1)},
+        {"SPN bit-sliced kernel", spn_kernel(CTR_DRBG::Cipher::Bitsliced, 1)},
+        {"CTR-DRBG, 4 threads", spn_kernel(CTR_DRBG::Cipher::Reference, THREADS)},
+        {"CTR-DRBG-T, 4 threads", spn_kernel(CTR_DRBG::Cipher::TTable, THREADS)},
+        {"CTR-DRBG-BS, 4 threads", spn_kernel(CTR_DRBG::Cipher::Bitsliced, THREADS)},
+        {"Hash_df", hash_df()},
+        {"Hash-DRBG vs spec model", hash_drbg(1)},
+        {"Hash-DRBG vs spec model, 4 threads", hash_drbg(THREADS)},
+    };
+}
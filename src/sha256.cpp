@@ -0,0 +1,367 @@
+/**
+ * @file sha256.cpp
+ * @brief Implementation of the incremental SHA-256 and HMAC-SHA256 contexts
+ */
+
+#include "sha256.hpp"
+#include "cpu_features.hpp"
+#include "kat.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SHA256_HAVE_X86_KERNELS 1
+#endif
+
+// ============================================================================
+// SHA-256 Compression Kernels
+// ============================================================================
+
+namespace {
+    using CompressFn = void (*)(uint32_t*, const uint8_t*, size_t);
+
+    // Portable kernel: the constexpr reference rounds from sha256.hpp
+    void compress_scalar(uint32_t state[8], const uint8_t* blocks, size_t num_blocks) {
+        for (size_t n = 0; n < num_blocks; ++n, blocks += SHA256::BLOCK_SIZE) {
+            sha256_detail::compress_block(state, blocks);
+        }
+    }
+
+#ifdef SHA256_HAVE_X86_KERNELS
+    /**
+     * SHA-NI kernel. The state is kept as the ABEF/CDGH register pair expected
+     * by sha256rnds2; each loop iteration performs four rounds, and the
+     * message schedule is advanced with sha256msg1/sha256msg2 on the ring of
+     * four message registers.
+     */
+    __attribute__((target("sha,sse4.1,ssse3")))
+    void compress_shani(uint32_t state[8], const uint8_t* blocks, size_t num_blocks) {
+        const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // Load state and reorder to ABEF / CDGH
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);              // CDAB
+        state1 = _mm_shuffle_epi32(state1, 0x1B);        // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);     // CDGH
+
+        for (size_t n = 0; n < num_blocks; ++n, blocks += SHA256::BLOCK_SIZE) {
+            const __m128i abef_save = state0;
+            const __m128i cdgh_save = state1;
+            __m128i msg[4];
+
+#pragma GCC unroll 16
+            for (int i = 0; i < 16; ++i) {
+                __m128i& cur = msg[i % 4];
+                if (i < 4) {
+                    cur = _mm_shuffle_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)), byte_swap);
+                }
+                __m128i wk = _mm_add_epi32(
+                    cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sha256_detail::K[i * 4])));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+
+                // W[t+4..t+7] += W[t-3..t]-shifted terms, then finish with msg2
+                if (i >= 3 && i <= 14) {
+                    __m128i& next = msg[(i + 1) % 4];
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msg[(i + 3) % 4], 4));
+                    next = _mm_sha256msg2_epu32(next, cur);
+                }
+
+                wk = _mm_shuffle_epi32(wk, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+
+                if (i >= 1 && i <= 12) {
+                    __m128i& prev = msg[(i + 3) % 4];
+                    prev = _mm_sha256msg1_epu32(prev, cur);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, abef_save);
+            state1 = _mm_add_epi32(state1, cdgh_save);
+        }
+
+        // Reorder back to ABCD / EFGH and store
+        tmp = _mm_shuffle_epi32(state0, 0x1B);           // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);        // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);     // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);        // ABEF
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+    }
+
+    // ---- AVX2 8-lane multi-buffer kernel ----------------------------------
+
+    __attribute__((target("avx2")))
+    inline __m256i rotr8(__m256i x, int n) {
+        return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+    }
+
+    // 8x8 transpose of 32-bit words: row j of the input becomes column j
+    __attribute__((target("avx2")))
+    inline void transpose8x8(__m256i r[8]) {
+        __m256i t[8], u[8];
+        for (int i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+            u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+            u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+            u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+        }
+        for (int i = 0; i < 4; ++i) {
+            r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
+    /**
+     * Eight independent compressions, one per 32-bit lane. Each vector holds
+     * the same working variable (or message word) for all eight messages, so
+     * the 64 rounds are the scalar rounds with every operation widened.
+     */
+    __attribute__((target("avx2")))
+    void compress_x8_avx2(SHA256::State* states, const uint8_t* blocks) {
+        const __m256i byte_swap = _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+        // Message words: w[t] holds word t of every lane's block
+        __m256i w[16];
+        for (int half = 0; half < 2; ++half) {
+            __m256i rows[8];
+            for (int lane = 0; lane < 8; ++lane) {
+                rows[lane] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                    blocks + lane * SHA256::BLOCK_SIZE + half * 32)), byte_swap);
+            }
+            transpose8x8(rows);
+            for (int i = 0; i < 8; ++i) w[half * 8 + i] = rows[i];
+        }
+
+        // Working variables: v[k] holds state word k of every lane
+        __m256i v[8];
+        for (int lane = 0; lane < 8; ++lane) {
+            v[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states[lane].data()));
+        }
+        transpose8x8(v);
+        __m256i a = v[0], b = v[1], c = v[2], d = v[3];
+        __m256i e = v[4], f = v[5], g = v[6], hh = v[7];
+
+        for (int i = 0; i < 64; ++i) {
+            // Extend the schedule in a 16-word ring
+            if (i >= 16) {
+                __m256i w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w2, 17), rotr8(w2, 19)),
+                                              _mm256_srli_epi32(w2, 10));
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w15, 7), rotr8(w15, 18)),
+                                              _mm256_srli_epi32(w15, 3));
+                w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0),
+                                             _mm256_add_epi32(s1, w[(i - 7) & 15]));
+            }
+
+            __m256i big_s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(e, 6), rotr8(e, 11)), rotr8(e, 25));
+            __m256i chv = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(hh, big_s1),
+                _mm256_add_epi32(_mm256_add_epi32(chv, w[i & 15]),
+                                 _mm256_set1_epi32(static_cast<int>(sha256_detail::K[i]))));
+            __m256i big_s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(a, 2), rotr8(a, 13)), rotr8(a, 22));
+            __m256i majv = _mm256_xor_si256(_mm256_and_si256(a, b),
+                                            _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+            __m256i t2 = _mm256_add_epi32(big_s0, majv);
+            hh = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(t1, t2);
+        }
+
+        // Back to per-lane layout and add into the chaining values
+        v[0] = a; v[1] = b; v[2] = c; v[3] = d;
+        v[4] = e; v[5] = f; v[6] = g; v[7] = hh;
+        transpose8x8(v);
+        for (int lane = 0; lane < 8; ++lane) {
+            __m256i* dst = reinterpret_cast<__m256i*>(states[lane].data());
+            _mm256_storeu_si256(dst, _mm256_add_epi32(_mm256_loadu_si256(dst), v[lane]));
+        }
+    }
+#endif
+
+    struct CompressKernel {
+        CompressFn fn;
+        const char* name;
+    };
+
+    CompressKernel select_kernel() {
+#ifdef SHA256_HAVE_X86_KERNELS
+        const auto& cpu = CpuFeatures::get();
+        if (cpu.sha && cpu.sse41 && cpu.ssse3) {
+            return {compress_shani, "SHA-NI"};
+        }
+#endif
+        return {compress_scalar, "scalar"};
+    }
+
+    // Chosen once, on first use, from the cpuid feature bits
+    const CompressKernel& active_kernel() {
+        static const CompressKernel kernel = select_kernel();
+        return kernel;
+    }
+}
+
+// ============================================================================
+// SHA-256 Implementation
+// ============================================================================
+
+void SHA256::compress(uint32_t state[8], const uint8_t* blocks, size_t num_blocks) {
+    active_kernel().fn(state, blocks, num_blocks);
+}
+
+std::string SHA256::kernelName() {
+    return active_kernel().name;
+}
+
+void SHA256::compressLanes(State* states, const uint8_t* blocks, size_t num_lanes) {
+    size_t lane = 0;
+#ifdef SHA256_HAVE_X86_KERNELS
+    if (CpuFeatures::get().avx2) {
+        for (; lane + 8 <= num_lanes; lane += 8) {
+            compress_x8_avx2(states + lane, blocks + lane * BLOCK_SIZE);
+        }
+    }
+#endif
+    // Scalar tail
+    for (; lane < num_lanes; ++lane) {
+        compress(states[lane].data(), blocks + lane * BLOCK_SIZE, 1);
+    }
+}
+
+size_t SHA256::multiBufferLanes() {
+    const auto& cpu = CpuFeatures::get();
+    // A single SHA-NI stream is faster than eight AVX2 lanes
+    return (cpu.avx2 && !cpu.sha) ? 8 : 1;
+}
+
+void SHA256::reset() {
+    h = INITIAL_STATE;
+    buffer_len = 0;
+    total_len = 0;
+}
+
+void SHA256::update(const uint8_t* data, size_t len) {
+    total_len += len;
+
+    // Top up a partially filled block first
+    if (buffer_len > 0) {
+        size_t take = std::min(len, BLOCK_SIZE - buffer_len);
+        std::copy(data, data + take, buffer.begin() + buffer_len);
+        buffer_len += take;
+        data += take;
+        len -= take;
+        if (buffer_len < BLOCK_SIZE) return;
+        compress(h.data(), buffer.data(), 1);
+        buffer_len = 0;
+    }
+
+    // Whole blocks are compressed straight from the caller's memory
+    size_t full_blocks = len / BLOCK_SIZE;
+    if (full_blocks > 0) {
+        compress(h.data(), data, full_blocks);
+        data += full_blocks * BLOCK_SIZE;
+        len -= full_blocks * BLOCK_SIZE;
+    }
+
+    std::copy(data, data + len, buffer.begin());
+    buffer_len = len;
+}
+
+SHA256::Digest SHA256::finalize() {
+    uint64_t bit_len = total_len * 8;
+
+    // Pre-processing: 0x80 terminator, zero fill, 64-bit big-endian length
+    buffer[buffer_len++] = 0x80;
+    if (buffer_len > BLOCK_SIZE - 8) {
+        std::fill(buffer.begin() + buffer_len, buffer.end(), 0);
+        compress(h.data(), buffer.data(), 1);
+        buffer_len = 0;
+    }
+    std::fill(buffer.begin() + buffer_len, buffer.end() - 8, 0);
+    for (int i = 0; i < 8; ++i) {
+        buffer[BLOCK_SIZE - 1 - i] = static_cast<uint8_t>((bit_len >> (i * 8)) & 0xFF);
+    }
+    compress(h.data(), buffer.data(), 1);
+    buffer_len = 0;
+
+    // Produce final hash
+    Digest result;
+    storeDigest(h, result.data());
+    return result;
+}
+
+SHA256::Digest SHA256::hash(const uint8_t* data, size_t len) {
+    SHA256 ctx;
+    ctx.update(data, len);
+    return ctx.finalize();
+}
+
+// ============================================================================
+// HMAC-SHA256 Implementation
+// ============================================================================
+
+HMAC_SHA256::HMAC_SHA256(const uint8_t* key, size_t key_len) {
+    if (key_len > SHA256::BLOCK_SIZE) {
+        throw std::invalid_argument("HMAC_SHA256: key longer than one block");
+    }
+
+    // Inner and outer padded keys
+    std::array<uint8_t, SHA256::BLOCK_SIZE> i_key_pad;
+    std::array<uint8_t, SHA256::BLOCK_SIZE> o_key_pad;
+    for (size_t i = 0; i < SHA256::BLOCK_SIZE; ++i) {
+        uint8_t k = (i < key_len) ? key[i] : 0x00;
+        i_key_pad[i] = k ^ 0x36;
+        o_key_pad[i] = k ^ 0x5c;
+    }
+
+    inner.update(i_key_pad);
+    outer.update(o_key_pad);
+}
+
+SHA256::Digest HMAC_SHA256::finalize() {
+    auto inner_hash = inner.finalize();
+    outer.update(inner_hash);
+    return outer.finalize();
+}
+
+// ============================================================================
+// Compile-time Known-Answer Tests
+// ============================================================================
+
+// FIPS 180-2 examples: empty message, one block, two-block padding
+static_assert(kat::matchesHex(SHA256::hashConst(kat::bytes("")),
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"),
+    "SHA-256 KAT failed (empty message)");
+static_assert(kat::matchesHex(SHA256::hashConst(kat::bytes("abc")),
+    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"),
+    "SHA-256 KAT failed (\"abc\")");
+static_assert(kat::matchesHex(SHA256::hashConst(
+    kat::bytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"),
+    "SHA-256 KAT failed (56-byte message)");
+
+// RFC 4231 test cases 1 and 2
+static_assert(kat::matchesHex(HMAC_SHA256::macConst(
+    std::array<uint8_t, 20>{0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+                            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b},
+    kat::bytes("Hi There")),
+    "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"),
+    "HMAC-SHA256 KAT failed (RFC 4231 case 1)");
+static_assert(kat::matchesHex(HMAC_SHA256::macConst(
+    kat::bytes("Jefe"), kat::bytes("what do ya want for nothing?")),
+    "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"),
+    "HMAC-SHA256 KAT failed (RFC 4231 case 2)");
@@ -0,0 +1,197 @@
+/**
+ * @file shared_ctr_drbg.cpp
+ * @brief SharedCTR_DRBG counter reservation, epoch slots and key rotation
+ */
+
+#include "shared_ctr_drbg.hpp"
+#include <cstring>
+
+namespace {
+    // counter += blocks, as a 128-bit big-endian integer
+    void add_blocks(AES256::Block& counter, uint64_t blocks) {
+        uint64_t carry = blocks;
+        for (int i = AES256::BLOCK_SIZE - 1; i >= 0 && carry != 0; --i) {
+            carry += counter[i];
+            counter[i] = static_cast<uint8_t>(carry);
+            carry >>= 8;
+        }
+    }
+
+    // Zero key material that is about to go out of scope, where a plain
+    // memset could be dropped as a dead store
+    void secure_wipe(void* data, size_t size) {
+        std::memset(data, 0, size);
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+    }
+}
+
+SharedCTR_DRBG::SharedCTR_DRBG(const std::vector<uint8_t>& seed) : reservation(0) {
+    // Instantiate as AES_CTR_DRBG does: update from key 0, V 0
+    current_keys = AES256::expandKey(AES256::Key{});
+    current_base.fill(0);
+    SeedMaterial provided = AES_CTR_DRBG::block_cipher_df(seed);
+    advance_epoch(0, current_base, provided);
+    secure_wipe(provided.data(), provided.size());
+}
+
+SharedCTR_DRBG::~SharedCTR_DRBG() {
+    uint32_t epoch = currentEpoch();
+    retire_slot(epoch);
+    retire_slot(epoch + 1);
+    secure_wipe(current_keys.data(), current_keys.size());
+    secure_wipe(current_base.data(), current_base.size());
+}
+
+// ============================================================================
+// Epoch slots (seqlock: odd sequence while a writer is inside)
+// ============================================================================
+
+bool SharedCTR_DRBG::read_slot(uint32_t epoch, Snapshot& out) const {
+    const EpochSlot& slot = slots[epoch & 1];
+    const uint64_t expected = 2 * uint64_t(epoch) + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+
+    uint64_t words[KEY_WORDS + 2];
+    for (size_t i = 0; i < KEY_WORDS; ++i) {
+        words[i] = slot.round_keys[i].load(std::memory_order_relaxed);
+    }
+    words[KEY_WORDS] = slot.base[0].load(std::memory_order_relaxed);
+    words[KEY_WORDS + 1] = slot.base[1].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    bool valid = slot.sequence.load(std::memory_order_relaxed) == expected;
+    if (valid) {
+        std::memcpy(out.round_keys.data(), words, sizeof(out.round_keys));
+        std::memcpy(out.base.data(), words + KEY_WORDS, sizeof(out.base));
+    }
+    secure_wipe(words, sizeof(words));
+    return valid;
+}
+
+void SharedCTR_DRBG::write_slot(uint32_t epoch) {
+    EpochSlot& slot = slots[epoch & 1];
+    uint64_t words[KEY_WORDS + 2];
+    std::memcpy(words, current_keys.data(), sizeof(current_keys));
+    std::memcpy(words + KEY_WORDS, current_base.data(), sizeof(current_base));
+
+    slot.sequence.store(2 * uint64_t(epoch) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < KEY_WORDS; ++i) {
+        slot.round_keys[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.base[0].store(words[KEY_WORDS], std::memory_order_relaxed);
+    slot.base[1].store(words[KEY_WORDS + 1], std::memory_order_relaxed);
+    slot.sequence.store(2 * uint64_t(epoch) + 2, std::memory_order_release);
+
+    secure_wipe(words, sizeof(words));
+}
+
+void SharedCTR_DRBG::retire_slot(uint32_t epoch) {
+    EpochSlot& slot = slots[epoch & 1];
+    slot.sequence.store(2 * uint64_t(epoch) + 3, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < KEY_WORDS; ++i) {
+        slot.round_keys[i].store(0, std::memory_order_relaxed);
+    }
+    slot.base[0].store(0, std::memory_order_relaxed);
+    slot.base[1].store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Rotation
+// ============================================================================
+
+void SharedCTR_DRBG::advance_epoch(uint32_t epoch, AES256::Block counter, const SeedMaterial& provided) {
+    SeedMaterial temp;
+    AES256::ctrKeystream(current_keys, counter.data(), temp.data(), temp.size() / BLOCK_SIZE);
+    for (size_t i = 0; i < temp.size(); ++i) {
+        temp[i] ^= provided[i];
+    }
+
+    AES256::Key key;
+    std::copy(temp.begin(), temp.begin() + key.size(), key.begin());
+    std::copy(temp.begin() + key.size(), temp.end(), current_base.begin());
+    current_keys = AES256::expandKey(key);
+    secure_wipe(key.data(), key.size());
+    secure_wipe(temp.data(), temp.size());
+
+    // Publish the new slot before any reservation can name its epoch, and
+    // wipe the old one only once no new reservation can name it
+    write_slot(epoch + 1);
+    reservation.store(uint64_t(epoch + 1) << OFFSET_BITS, std::memory_order_release);
+    retire_slot(epoch);
+}
+
+void SharedCTR_DRBG::rotate(uint32_t epoch) {
+    std::lock_guard<std::mutex> guard(rotate_lock);
+    if (currentEpoch() != epoch) {
+        return;  // Another thread rotated first
+    }
+    // The update reads counter values past the budget, which no request got
+    AES256::Block counter = current_base;
+    add_blocks(counter, EPOCH_BLOCKS);
+    advance_epoch(epoch, counter, SeedMaterial{});
+}
+
+void SharedCTR_DRBG::reseed(const std::vector<uint8_t>& seed) {
+    SeedMaterial provided = AES_CTR_DRBG::block_cipher_df(seed);
+    {
+        std::lock_guard<std::mutex> guard(rotate_lock);
+        AES256::Block counter = current_base;
+        add_blocks(counter, EPOCH_BLOCKS);
+        advance_epoch(currentEpoch(), counter, provided);
+    }
+    secure_wipe(provided.data(), provided.size());
+}
+
+// ============================================================================
+// Generation
+// ============================================================================
+
+void SharedCTR_DRBG::generateInto(uint8_t* out, size_t num_bits) {
+    size_t num_bytes = (num_bits + 7) / 8;
+    size_t offset = 0;
+    Snapshot snap;
+    while (offset < num_bytes) {
+        size_t request_bytes = std::min(MAX_REQUEST_BYTES, num_bytes - offset);
+        uint64_t blocks = (request_bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        uint64_t start;
+        for (;;) {
+            // Once the budget is spent, rotate without adding to the offset,
+            // so it stays far below the epoch bits (see MAX_THREADS)
+            uint64_t word = reservation.load(std::memory_order_acquire);
+            if ((word & OFFSET_MASK) + blocks > EPOCH_BLOCKS) {
+                rotate(static_cast<uint32_t>(word >> OFFSET_BITS));
+                continue;
+            }
+
+            word = reservation.fetch_add(blocks, std::memory_order_acquire);
+            uint32_t epoch = static_cast<uint32_t>(word >> OFFSET_BITS);
+            start = word & OFFSET_MASK;
+            if (start + blocks > EPOCH_BLOCKS) {
+                rotate(epoch);
+            } else if (read_slot(epoch, snap)) {
+                break;
+            }
+            // Otherwise the epoch ended after the reservation; take another
+        }
+
+        add_blocks(snap.base, start);
+        size_t full_blocks = request_bytes / BLOCK_SIZE;
+        AES256::ctrKeystream(snap.round_keys, snap.base.data(), out + offset, full_blocks);
+        offset += full_blocks * BLOCK_SIZE;
+
+        // A partial last block goes through a local buffer
+        size_t tail = request_bytes % BLOCK_SIZE;
+        if (tail > 0) {
+            AES256::Block last;
+            AES256::ctrKeystream(snap.round_keys, snap.base.data(), last.data(), 1);
+            std::copy(last.begin(), last.begin() + tail, out + offset);
+            offset += tail;
+        }
+    }
+    secure_wipe(&snap, sizeof(snap));
+}
@@ -0,0 +1,245 @@
+/**
+ * @file spn_bitslice.cpp
+ * @brief AVX2 bit-sliced implementation of the CTR_DRBG SPN cipher
+ *
+ * State layout for a batch of 32 blocks: planes[h][b] is a vector of eight
+ * 32-bit lanes; lane k holds bit b of byte position 8h + k, one bit per
+ * block. Because each 128-bit half of a vector then holds exactly one
+ * 4-byte column, MixColumns only needs in-lane dword shuffles, and the
+ * byte permutation is a cross-lane dword permute plus blend.
+ */
+
+#include "spn_bitslice.hpp"
+#include "sbox_circuit.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPN_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace {
+    constexpr size_t BLOCK_SIZE = 16;
+
+    void increment_be128(uint8_t counter[16]) {
+        for (int i = BLOCK_SIZE - 1; i >= 0; --i) {
+            if (++counter[i] != 0) break;
+        }
+    }
+}
+
+#ifdef SPN_HAVE_AVX2_KERNEL
+
+namespace {
+    // GCC vector type: ^, & and ~ map straight onto AVX2 instructions, so the
+    // generic S-box circuit can be instantiated on it
+    typedef uint32_t u32x8 __attribute__((vector_size(32)));
+
+    struct Planes {
+        u32x8 p[2][8];  // [half][bit]
+    };
+
+    __attribute__((target("avx2")))
+    inline u32x8 permute(u32x8 v, __m256i idx) {
+        return (u32x8)_mm256_permutevar8x32_epi32((__m256i)v, idx);
+    }
+
+    /**
+     * In-lane 16x16 byte transpose: four rounds of interleaving register i
+     * with register i + 8. Row i of each 128-bit lane becomes column i.
+     */
+    __attribute__((target("avx2")))
+    inline void transpose_16x16_epi8(__m256i r[16]) {
+        for (int pass = 0; pass < 4; ++pass) {
+            __m256i t[16];
+            for (int i = 0; i < 8; ++i) {
+                t[2 * i] = _mm256_unpacklo_epi8(r[i], r[i + 8]);
+                t[2 * i + 1] = _mm256_unpackhi_epi8(r[i], r[i + 8]);
+            }
+            for (int i = 0; i < 16; ++i) r[i] = t[i];
+        }
+    }
+
+    /**
+     * Bit-slice 32 blocks: transpose to one 32-byte vector per byte position
+     * (blocks 0..15 in the low lane, 16..31 in the high lane), then peel off
+     * the bits MSB first with movemask.
+     */
+    __attribute__((target("avx2")))
+    void load_planes(const uint8_t* blocks, Planes& s) {
+        __m256i r[16];
+        for (size_t i = 0; i < 16; ++i) {
+            r[i] = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * BLOCK_SIZE))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + (i + 16) * BLOCK_SIZE)), 1);
+        }
+        transpose_16x16_epi8(r);
+
+        alignas(32) uint32_t words[8][BLOCK_SIZE];
+        for (size_t pos = 0; pos < BLOCK_SIZE; ++pos) {
+            __m256i v = r[pos];
+            for (int b = 7; b >= 0; --b) {
+                words[b][pos] = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+                v = _mm256_add_epi8(v, v);
+            }
+        }
+
+        for (int b = 0; b < 8; ++b) {
+            for (int h = 0; h < 2; ++h) {
+                s.p[h][b] = (u32x8)_mm256_load_si256(reinterpret_cast<const __m256i*>(&words[b][h * 8]));
+            }
+        }
+    }
+
+    /**
+     * Inverse of load_planes: expand each 32-bit plane word to a byte mask
+     * per block, accumulate the bits of every byte position, and transpose
+     * back to block order.
+     */
+    __attribute__((target("avx2")))
+    void store_planes(const Planes& s, uint8_t* blocks) {
+        alignas(32) uint32_t words[8][BLOCK_SIZE];
+        for (int b = 0; b < 8; ++b) {
+            for (int h = 0; h < 2; ++h) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(&words[b][h * 8]), (__m256i)s.p[h][b]);
+            }
+        }
+
+        // Byte n of the spread word carries word byte n / 8; bit_select picks bit n % 8
+        const __m256i spread = _mm256_setr_epi8(
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i bit_select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+
+        __m256i r[16];
+        for (size_t pos = 0; pos < BLOCK_SIZE; ++pos) {
+            __m256i acc = _mm256_setzero_si256();
+            for (int b = 0; b < 8; ++b) {
+                __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(words[b][pos])), spread);
+                v = _mm256_cmpeq_epi8(_mm256_and_si256(v, bit_select), bit_select);
+                acc = _mm256_or_si256(acc, _mm256_and_si256(v, _mm256_set1_epi8(static_cast<char>(1 << b))));
+            }
+            r[pos] = acc;
+        }
+        transpose_16x16_epi8(r);
+
+        for (size_t i = 0; i < 16; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(blocks + i * BLOCK_SIZE), _mm256_castsi256_si128(r[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(blocks + (i + 16) * BLOCK_SIZE),
+                             _mm256_extracti128_si256(r[i], 1));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void encrypt_batch(const Planes* key_planes, int rounds, const uint8_t* in, uint8_t* out) {
+        // Output byte i reads input byte (i + i/4) % 16:
+        //   positions 0..7  <- 0 1 2 3 5 6 7 | 8
+        //   positions 8..15 <- 10 11 12 13 15 | 0 1 2
+        const __m256i perm_lo_a = _mm256_setr_epi32(0, 1, 2, 3, 5, 6, 7, 0);
+        const __m256i perm_lo_b = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0);
+        const __m256i perm_hi_a = _mm256_setr_epi32(2, 3, 4, 5, 7, 0, 0, 0);
+        const __m256i perm_hi_b = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 1, 2);
+
+        Planes s;
+        load_planes(in, s);
+
+        for (int round = 0; round < rounds; ++round) {
+            // AddRoundKey
+            for (int b = 0; b < 8; ++b) {
+                s.p[0][b] ^= key_planes[round].p[0][b];
+                s.p[1][b] ^= key_planes[round].p[1][b];
+            }
+
+            // SubBytes
+            aes_sbox_circuit(s.p[0]);
+            aes_sbox_circuit(s.p[1]);
+
+            // Byte permutation
+            for (int b = 0; b < 8; ++b) {
+                u32x8 lo = s.p[0][b], hi = s.p[1][b];
+                s.p[0][b] = (u32x8)_mm256_blend_epi32(
+                    (__m256i)permute(lo, perm_lo_a), (__m256i)permute(hi, perm_lo_b), 0x80);
+                s.p[1][b] = (u32x8)_mm256_blend_epi32(
+                    (__m256i)permute(hi, perm_hi_a), (__m256i)permute(lo, perm_hi_b), 0xE0);
+            }
+
+            // MixColumns: x_j ^= t ^ ((x_j ^ x_{j+1}) << 1). The byte shift
+            // moves plane b - 1 into plane b; each 128-bit half is one column.
+            if (round < rounds - 1) {
+                for (int h = 0; h < 2; ++h) {
+                    u32x8 diff_prev = {};
+                    for (int b = 0; b < 8; ++b) {
+                        __m256i x = (__m256i)s.p[h][b];
+                        __m256i next = _mm256_shuffle_epi32(x, 0x39);        // x_{j+1}
+                        __m256i pair = _mm256_xor_si256(x, _mm256_shuffle_epi32(x, 0x4E));
+                        __m256i t = _mm256_xor_si256(pair, _mm256_shuffle_epi32(pair, 0x39));
+                        u32x8 diff = (u32x8)_mm256_xor_si256(x, next);
+                        s.p[h][b] = (u32x8)_mm256_xor_si256(x, t) ^ diff_prev;
+                        diff_prev = diff;
+                    }
+                }
+            }
+        }
+
+        store_planes(s, out);
+    }
+}
+
+#endif // SPN_HAVE_AVX2_KERNEL
+
+namespace spn_bitslice {
+
+bool available() {
+#ifdef SPN_HAVE_AVX2_KERNEL
+    return CpuFeatures::get().avx2;
+#else
+    return false;
+#endif
+}
+
+#ifdef SPN_HAVE_AVX2_KERNEL
+__attribute__((target("avx2")))
+#endif
+void keystream(const uint32_t* round_keys, int rounds, uint8_t counter[16],
+               uint8_t* out, size_t num_blocks) {
+    if (rounds > MAX_ROUNDS) {
+        throw std::invalid_argument("spn_bitslice: too many rounds");
+    }
+#ifdef SPN_HAVE_AVX2_KERNEL
+    // Round keys are identical across blocks: each plane lane is all-ones or
+    // all-zeros. Expanded once per call and shared by every batch.
+    Planes key_planes[MAX_ROUNDS];
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t pos = 0; pos < BLOCK_SIZE; ++pos) {
+            uint32_t byte = (round_keys[round * 4 + pos / 4] >> (8 * (pos % 4))) & 0xFF;
+            for (int b = 0; b < 8; ++b) {
+                key_planes[round].p[pos / 8][b][pos % 8] = ((byte >> b) & 1) ? 0xFFFFFFFFu : 0u;
+            }
+        }
+    }
+
+    uint8_t in[BATCH_BLOCKS * BLOCK_SIZE];
+    uint8_t tail[BATCH_BLOCKS * BLOCK_SIZE];
+    for (size_t done = 0; done < num_blocks; done += BATCH_BLOCKS) {
+        size_t count = std::min(BATCH_BLOCKS, num_blocks - done);
+        for (size_t n = 0; n < BATCH_BLOCKS; ++n) {
+            // Unused lanes of a final partial batch just see a stale counter
+            if (n < count) increment_be128(counter);
+            std::copy(counter, counter + BLOCK_SIZE, in + n * BLOCK_SIZE);
+        }
+
+        if (count == BATCH_BLOCKS) {
+            encrypt_batch(key_planes, rounds, in, out + done * BLOCK_SIZE);
+        } else {
+            encrypt_batch(key_planes, rounds, in, tail);
+            std::copy(tail, tail + count * BLOCK_SIZE, out + done * BLOCK_SIZE);
+        }
+    }
+#else
+    (void)round_keys; (void)rounds; (void)counter; (void)out; (void)num_blocks;
+#endif
+}
+
+} // namespace spn_bitslice